@@ -0,0 +1,220 @@
+// LevelParseBench.cpp
+// Compares the former DOM map loader (nlohmann::json::parse, then walking the
+// tree) against LevelFormat's streaming SAX parser, on the shipped maps and a
+// generated 1000x1000 map, which is also timed with base64 + zlib layer data.
+// Reports time per parse and peak heap use during the parse, measured by
+// counting every operator new/delete.
+//
+// The DOM side only builds the tree and copies the GIDs out; the SAX side
+// also decodes transforms, resolves tilesets and builds the collision grid,
+// so the comparison understates the SAX advantage.
+#define SDL_MAIN_HANDLED
+#include "LevelFormat.h"
+#include "json.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace
+{
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+
+    // Each block carries its size in a 16-byte prefix so delete can account for it.
+    const size_t HEADER = 16;
+
+    void *trackedAlloc(size_t size)
+    {
+        char *block = static_cast<char *>(std::malloc(size + HEADER));
+        if (!block)
+            throw std::bad_alloc();
+        *reinterpret_cast<size_t *>(block) = size;
+        liveBytes += size;
+        if (liveBytes > peakBytes)
+            peakBytes = liveBytes;
+        return block + HEADER;
+    }
+
+    void trackedFree(void *ptr)
+    {
+        if (!ptr)
+            return;
+        char *block = static_cast<char *>(ptr) - HEADER;
+        liveBytes -= *reinterpret_cast<size_t *>(block);
+        std::free(block);
+    }
+}
+
+void *operator new(size_t size) { return trackedAlloc(size); }
+void *operator new[](size_t size) { return trackedAlloc(size); }
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { trackedFree(ptr); }
+
+namespace
+{
+    using json = nlohmann::json;
+
+    struct Result
+    {
+        double ms;
+        size_t peak;
+        size_t tiles;
+    };
+
+    // The loader as it was before the SAX parser: full DOM, then extraction.
+    size_t parseDom(const std::vector<char> &text)
+    {
+        json level = json::parse(text.begin(), text.end());
+        std::vector<std::vector<std::uint32_t>> layers;
+        for (const auto &layerJson : level["layers"])
+        {
+            if (layerJson["type"] != "tilelayer")
+                continue;
+            std::vector<std::uint32_t> tiles;
+            for (const auto &gid : layerJson["data"])
+                tiles.push_back(gid.get<std::uint32_t>());
+            layers.push_back(std::move(tiles));
+        }
+        size_t tiles = 0;
+        for (const auto &layer : layers)
+            tiles += layer.size();
+        return tiles;
+    }
+
+    size_t parseSax(const std::vector<char> &text)
+    {
+        LevelData data;
+        LevelFormat::parseJson(text.data(), text.size(), data);
+        size_t tiles = 0;
+        for (const auto &layer : data.layers)
+            tiles += layer.tiles.size();
+        return tiles;
+    }
+
+    template <typename Parse>
+    Result measure(const std::vector<char> &text, int iterations, Parse parse)
+    {
+        Result result = {0.0, 0, 0};
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            size_t baseline = liveBytes;
+            peakBytes = liveBytes;
+            result.tiles = parse(text);
+            if (peakBytes - baseline > result.peak)
+                result.peak = peakBytes - baseline;
+        }
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+        return result;
+    }
+
+    std::string encodeBase64(const std::vector<unsigned char> &bytes)
+    {
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string text;
+        for (size_t i = 0; i < bytes.size(); i += 3)
+        {
+            std::uint32_t chunk = bytes[i] << 16;
+            if (i + 1 < bytes.size())
+                chunk |= bytes[i + 1] << 8;
+            if (i + 2 < bytes.size())
+                chunk |= bytes[i + 2];
+            text += alphabet[(chunk >> 18) & 63];
+            text += alphabet[(chunk >> 12) & 63];
+            text += i + 1 < bytes.size() ? alphabet[(chunk >> 6) & 63] : '=';
+            text += i + 2 < bytes.size() ? alphabet[chunk & 63] : '=';
+        }
+        return text;
+    }
+
+    // A Tiled-style map with a full floor layer and a sparse wall layer
+    // (some tiles flipped or rotated), keys in the order Tiled writes them.
+    // With compress set, layer data is written as Tiled's base64 + zlib.
+    std::vector<char> generateMap(int width, int height, bool compress)
+    {
+        std::mt19937 rng(1234);
+        std::string text = "{ \"compressionlevel\":-1,\n \"height\":" + std::to_string(height) +
+                           ",\n \"infinite\":false,\n \"layers\":[";
+        const char *names[] = {"floor", "walls"};
+        for (int layer = 0; layer < 2; layer++)
+        {
+            std::vector<std::uint32_t> gids(static_cast<size_t>(width) * height);
+            for (auto &gid : gids)
+            {
+                if (layer == 0)
+                    gid = 2 + rng() % 4;
+                else
+                    gid = rng() % 20 == 0 ? 1 | ((rng() % 4) << 29) : 0;
+            }
+
+            text += layer ? ",\n  {\n" : "\n  {\n";
+            if (compress)
+            {
+                uLongf size = compressBound(static_cast<uLong>(gids.size() * 4));
+                std::vector<unsigned char> packed(size);
+                ::compress(packed.data(), &size, reinterpret_cast<const Bytef *>(gids.data()), static_cast<uLong>(gids.size() * 4));
+                packed.resize(size);
+                text += "   \"compression\":\"zlib\",\n   \"data\":\"" + encodeBase64(packed) +
+                        "\",\n   \"encoding\":\"base64\"";
+            }
+            else
+            {
+                text += "   \"data\":[";
+                for (size_t i = 0; i < gids.size(); i++)
+                    text += std::to_string(gids[i]) + (i + 1 < gids.size() ? ", " : "");
+                text += "]";
+            }
+            text += ",\n   \"height\":" + std::to_string(height) + ",\n   \"id\":" + std::to_string(layer + 1) +
+                    ",\n   \"name\":\"" + names[layer] + "\",\n   \"opacity\":1,\n   \"type\":\"tilelayer\",\n" +
+                    "   \"visible\":true,\n   \"width\":" + std::to_string(width) + ",\n   \"x\":0,\n   \"y\":0\n  }";
+        }
+        text += "],\n \"nextlayerid\":3,\n \"nextobjectid\":1,\n \"orientation\":\"orthogonal\",\n"
+                " \"renderorder\":\"right-down\",\n \"tiledversion\":\"1.11.0\",\n \"tileheight\":32,\n"
+                " \"tilesets\":[\n  { \"columns\":1, \"firstgid\":1, \"image\":\"wall2.png\", \"tileheight\":8, \"tilewidth\":32 },\n"
+                "  { \"columns\":4, \"firstgid\":2, \"image\":\"floor.png\", \"tileheight\":32, \"tilewidth\":32 }],\n"
+                " \"tilewidth\":32,\n \"type\":\"map\",\n \"version\":\"1.10\",\n \"width\":" +
+                std::to_string(width) + "\n}";
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    void report(const char *name, const std::vector<char> &text, int iterations)
+    {
+        Result dom = measure(text, iterations, parseDom);
+        Result sax = measure(text, iterations, parseSax);
+        std::printf("%-22s %8.1f KB  dom %9.3f ms %9.1f KB peak | sax %9.3f ms %9.1f KB peak | %.2fx faster, %.1fx less memory%s\n",
+                    name, text.size() / 1024.0, dom.ms, dom.peak / 1024.0, sax.ms, sax.peak / 1024.0,
+                    dom.ms / sax.ms, static_cast<double>(dom.peak) / sax.peak,
+                    dom.tiles == sax.tiles ? "" : " (TILE COUNT MISMATCH)");
+    }
+}
+
+int main()
+{
+    const char *maps[] = {"assets/map/map1.json", "assets/map/map2.json", "assets/map/map3.json"};
+    for (const char *map : maps)
+    {
+        std::vector<char> text;
+        if (!LevelFormat::readFile(map, text))
+        {
+            std::fprintf(stderr, "Failed to read %s (run from the repository root)\n", map);
+            return 1;
+        }
+        report(map, text, 50);
+    }
+
+    report("generated 1000x1000", generateMap(1000, 1000, false), 3);
+
+    // The DOM path never handled encoded layers, so only the SAX side runs here.
+    std::vector<char> compressed = generateMap(1000, 1000, true);
+    Result sax = measure(compressed, 3, parseSax);
+    std::printf("%-22s %8.1f KB  sax %9.3f ms %9.1f KB peak (base64 + zlib layers)\n",
+                "generated 1000x1000", compressed.size() / 1024.0, sax.ms, sax.peak / 1024.0);
+    return 0;
+}
@@ -0,0 +1,296 @@
+// MicroBench.cpp
+// Micro-benchmarks of the hot paths, printed as one JSON document for trend
+// tracking:
+//  - level_load/<map>: LevelFormat::parseJson of a map's JSON, read into
+//    memory first, so a cooked .lvl or assets.pak on disk does not change
+//    what is measured; per map (the three shipped maps and the infinite-map
+//    fixture);
+//  - level_render/<map>: Level::render of one 1280x720 view into a software
+//    renderer, per map;
+//  - collision_grid, collision_linear: CollisionHandler::checkCollision of a
+//    player-sized box against map1's walls, through the grid and the flat
+//    wall list;
+//  - transformed_rect: computeTransformedRect;
+//  - bullets/<n>: the bullet part of Game::update with n player bullets, n
+//    enemy bullets and n enemies (the copy of the 2n bullets is included);
+//  - enemy_update/<n>: Enemy::update of n enemies.
+// Each benchmark repeats a batch sized to run for about BATCH_MS and keeps
+// the fastest and median of SAMPLES batches. Needs no display: textures load
+// into a software renderer.
+//
+// Usage: MicroBench [--filter SUBSTRING] > results.json
+// Must be run from the repository root.
+#define SDL_MAIN_HANDLED
+#include "BulletCollision.h"
+#include "CollisionHandler.h"
+#include "Constants.h"
+#include "Enemy.h"
+#include "EventBus.h"
+#include "Level.h"
+#include "LevelFormat.h"
+#include "MathUtils.h"
+#include "Random.h"
+#include "ResourceManager.h"
+#include "json.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using json = nlohmann::ordered_json;
+
+    const char *const MAPS[] = {"map1", "map2", "map3", "infinite"};
+    const int POPULATIONS[] = {10, 100, 1000, 10000};
+    const double BATCH_MS = 50.0;
+    const int SAMPLES = 5;
+    const int RANDOM_INPUTS = 4096; // Precomputed inputs cycled through by the cheap benchmarks.
+
+    volatile long sink; // Keeps results alive so the optimizer cannot drop the work.
+
+    double elapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    class Suite
+    {
+    public:
+        explicit Suite(const char *filter) : filter(filter) {}
+
+        bool wants(const std::string &name) const { return !filter || name.find(filter) != std::string::npos; }
+
+        // Times op, called once per operation, and records ns per operation.
+        void run(const std::string &name, const std::function<void()> &op)
+        {
+            if (!wants(name))
+                return;
+
+            // Grow the batch until one takes BATCH_MS; this also warms up.
+            long batch = 1;
+            while (true)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (long i = 0; i < batch; i++)
+                    op();
+                if (elapsedNs(start) >= BATCH_MS * 1e6 || batch >= (1L << 30))
+                    break;
+                batch *= 2;
+            }
+
+            std::vector<double> samples;
+            for (int s = 0; s < SAMPLES; s++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (long i = 0; i < batch; i++)
+                    op();
+                samples.push_back(elapsedNs(start) / batch);
+            }
+            std::sort(samples.begin(), samples.end());
+
+            results.push_back({{"name", name},
+                               {"iterations", batch * SAMPLES},
+                               {"ns_per_op_min", samples.front()},
+                               {"ns_per_op_median", samples[SAMPLES / 2]}});
+            std::fprintf(stderr, "%-28s %14.1f ns/op\n", name.c_str(), samples[SAMPLES / 2]);
+        }
+
+        json report() const
+        {
+            return {{"suite", "MicroBench"},
+                    {"unit", "ns"},
+                    {"compiler", __VERSION__},
+                    {"results", results}};
+        }
+
+    private:
+        const char *filter;
+        json results = json::array();
+    };
+
+    std::string mapPath(const char *map)
+    {
+        return std::string("assets/map/") + map + ".json";
+    }
+
+    std::vector<SDL_Rect> randomBoxes(Random &rng, const SDL_Rect &bounds, int w, int h)
+    {
+        std::vector<SDL_Rect> boxes(RANDOM_INPUTS);
+        for (SDL_Rect &box : boxes)
+            box = {bounds.x + static_cast<int>(rng.nextFloat() * bounds.w),
+                   bounds.y + static_cast<int>(rng.nextFloat() * bounds.h), w, h};
+        return boxes;
+    }
+
+    void benchLevels(Suite &suite, SDL_Renderer *renderer)
+    {
+        for (const char *map : MAPS)
+        {
+            std::string name = std::string("level_load/") + map;
+            std::vector<char> text;
+            if (!suite.wants(name) || !LevelFormat::readFile(mapPath(map), text))
+                continue;
+            suite.run(name, [&]
+                      {
+                          LevelData data;
+                          LevelFormat::parseJson(text.data(), text.size(), data);
+                          sink += static_cast<long>(data.collision.getRects().size()); });
+        }
+
+        for (const char *map : MAPS)
+        {
+            std::string name = std::string("level_render/") + map;
+            if (!suite.wants(name))
+                continue;
+            Level level(renderer, mapPath(map));
+            SDL_Rect bounds = level.getBounds();
+            int cameraX = bounds.x + (bounds.w - 1280) / 2;
+            int cameraY = bounds.y + (bounds.h - 720) / 2;
+            level.update({cameraX, cameraY, 1280, 720});
+            suite.run(name, [&]
+                      {
+                          level.render(renderer, cameraX, cameraY);
+                          SDL_RenderFlush(renderer); });
+        }
+    }
+
+    void benchCollision(Suite &suite, Random &rng)
+    {
+        if (!suite.wants("collision"))
+            return;
+        Level level(mapPath(MAPS[0]));
+        const CollisionGrid &grid = level.getCollisionGrid();
+        const std::vector<SDL_Rect> &walls = grid.getRects();
+        std::vector<SDL_Rect> boxes = randomBoxes(rng, level.getBounds(), PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT);
+
+        size_t next = 0;
+        suite.run("collision_grid", [&]
+                  { sink += CollisionHandler::checkCollision(boxes[next++ % boxes.size()], grid); });
+        suite.run("collision_linear", [&]
+                  { sink += CollisionHandler::checkCollision(boxes[next++ % boxes.size()], walls); });
+    }
+
+    void benchTransformedRect(Suite &suite, Random &rng)
+    {
+        struct Input
+        {
+            int x, y;
+            double rotation;
+            SDL_RendererFlip flip;
+        };
+        std::vector<Input> inputs(RANDOM_INPUTS);
+        for (Input &input : inputs)
+            input = {static_cast<int>(rng.nextFloat() * 2000), static_cast<int>(rng.nextFloat() * 2000),
+                     rng.nextFloat() * 360.0, rng.next() % 2 ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE};
+
+        size_t next = 0;
+        suite.run("transformed_rect", [&]
+                  {
+                      const Input &input = inputs[next++ % inputs.size()];
+                      SDL_Rect rect = computeTransformedRect(input.x, input.y, DEFAULT_TILE_WIDTH, DEFAULT_TILE_HEIGHT,
+                                                             input.rotation, {DEFAULT_TILE_WIDTH / 2, DEFAULT_TILE_HEIGHT / 2}, input.flip);
+                      sink += rect.x; });
+    }
+
+    // Enemies and bullets scattered over the playable screen area, where
+    // Bullet::update keeps bullets alive.
+    void benchPopulations(Suite &suite, SDL_Renderer *renderer, Random &rng)
+    {
+        Level level(mapPath(MAPS[0]));
+        const CollisionGrid &walls = level.getCollisionGrid();
+        const SDL_Rect area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        const SDL_Rect playerBox = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT};
+
+        for (int population : POPULATIONS)
+        {
+            std::string bulletName = "bullets/" + std::to_string(population);
+            std::string enemyName = "enemy_update/" + std::to_string(population);
+            if (!suite.wants(bulletName) && !suite.wants(enemyName))
+                continue;
+
+            std::vector<std::unique_ptr<Enemy>> enemies;
+            std::vector<Bullet> playerBullets, enemyBullets;
+            for (int i = 0; i < population; i++)
+            {
+                enemies.push_back(std::make_unique<Enemy>(rng.nextFloat() * area.w, rng.nextFloat() * area.h, renderer));
+                float angle = rng.nextFloat() * 6.2831853f;
+                playerBullets.emplace_back(rng.nextFloat() * area.w, rng.nextFloat() * area.h,
+                                           std::cos(angle), std::sin(angle), WEAPON_BULLET_SPEED_PISTOL);
+                enemyBullets.emplace_back(rng.nextFloat() * area.w, rng.nextFloat() * area.h,
+                                          -std::cos(angle), -std::sin(angle), WEAPON_BULLET_SPEED_SHOTGUN);
+            }
+
+            EventBus events;
+            std::vector<Bullet> livePlayer, liveEnemy;
+            suite.run(bulletName, [&]
+                      {
+                          livePlayer = playerBullets;
+                          liveEnemy = enemyBullets;
+                          events.clear();
+                          BulletCollision::move(liveEnemy, FIXED_TIMESTEP);
+                          BulletCollision::hitPlayer(liveEnemy, playerBox, walls, events);
+                          BulletCollision::hitEnemies(livePlayer, enemies, walls, events);
+                          BulletCollision::removeInactive(livePlayer);
+                          BulletCollision::removeInactive(liveEnemy);
+                          sink += static_cast<long>(livePlayer.size() + liveEnemy.size()); });
+
+            // Enemies wander and shoot as the batches run, like in a long
+            // fight; the bullets they fire are dropped every tick.
+            std::vector<Bullet> fired;
+            suite.run(enemyName, [&]
+                      {
+                          fired.clear();
+                          events.clear();
+                          for (auto &enemy : enemies)
+                              enemy->update(FIXED_TIMESTEP, playerBox, walls, fired, events, true);
+                          sink += static_cast<long>(fired.size()); });
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--filter SUBSTRING]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 1280, 720, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer)
+    {
+        std::fprintf(stderr, "No software renderer: %s\n", SDL_GetError());
+        SDL_FreeSurface(target);
+        return 1;
+    }
+
+    Suite suite(filter);
+    Random rng(1);
+    benchLevels(suite, renderer);
+    benchCollision(suite, rng);
+    benchTransformedRect(suite, rng);
+    benchPopulations(suite, renderer, rng);
+
+    std::printf("%s\n", suite.report().dump(2).c_str());
+
+    // Textures belong to this renderer.
+    ResourceManager::clear();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+    return 0;
+}
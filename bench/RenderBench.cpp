@@ -0,0 +1,197 @@
+// RenderBench.cpp
+// Render cost without a GPU: draws each shipped map, and the infinite-map
+// fixture (which streams and bakes chunks), into an SDL_Surface through
+// SDL's software renderer while the camera flies over it, with N enemies
+// and a spread of bullets on the map. For every resolution and map it
+// reports the frame time, the share of it spent on the level, the
+// sprites (enemies and player) and the bullets, and the draw calls and
+// pixels filled per frame (RenderStats).
+//
+// SDL queues draw calls and rasterizes them when the queue is flushed, so
+// each part is followed by SDL_RenderFlush to charge the work to it.
+//
+// Usage: RenderBench [WxH ...] [--enemies N] [--frames N]
+// Must be run from the repository root.
+#define SDL_MAIN_HANDLED
+#include "Bullet.h"
+#include "Constants.h"
+#include "Enemy.h"
+#include "FrameHistogram.h"
+#include "Level.h"
+#include "Player.h"
+#include "Random.h"
+#include "RenderStats.h"
+#include "ResourceManager.h"
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char *const MAPS[] = {"assets/map/map1.json", "assets/map/map2.json", "assets/map/map3.json",
+                                "assets/map/infinite.json"};
+    const int WARMUP_FRAMES = 30;
+    const std::uint64_t SPAWN_SEED = 1; // Same enemy layout on every run.
+
+    struct Resolution
+    {
+        int w, h;
+    };
+
+    double elapsedMs(Uint64 start, Uint64 end)
+    {
+        return (end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    }
+
+    // Camera top-left for frame `frame` of `frames`: a Lissajous path that
+    // sweeps the whole map once, or holds the map centred on an axis where
+    // it is smaller than the view.
+    SDL_Point cameraAt(const SDL_Rect &bounds, const Resolution &view, int frame, int frames)
+    {
+        const float TWO_PI = 6.2831853f;
+        float t = static_cast<float>(frame) / frames;
+        float u = 0.5f + 0.5f * std::sin(TWO_PI * t);
+        float v = 0.5f + 0.5f * std::sin(2.0f * TWO_PI * t + 1.0f);
+        return {bounds.x + static_cast<int>((bounds.w - view.w) * u),
+                bounds.y + static_cast<int>((bounds.h - view.h) * v)};
+    }
+
+    void benchMap(SDL_Renderer *renderer, const Resolution &view, const char *mapPath, int enemyCount, int frames)
+    {
+        Level level(renderer, mapPath);
+        SDL_Rect bounds = level.getBounds();
+
+        Random rng(SPAWN_SEED);
+        auto randomPoint = [&](float &x, float &y)
+        {
+            x = bounds.x + rng.nextFloat() * bounds.w;
+            y = bounds.y + rng.nextFloat() * bounds.h;
+        };
+
+        std::vector<std::unique_ptr<Enemy>> enemies;
+        std::vector<Bullet> bullets;
+        for (int i = 0; i < enemyCount; i++)
+        {
+            float x, y;
+            randomPoint(x, y);
+            enemies.push_back(std::make_unique<Enemy>(x, y, renderer));
+
+            // Two bullets per enemy, the rough density of a firefight.
+            for (int b = 0; b < 2; b++)
+            {
+                float angle = rng.nextFloat() * 6.2831853f;
+                randomPoint(x, y);
+                bullets.emplace_back(x, y, std::cos(angle), std::sin(angle), WEAPON_BULLET_SPEED_SHOTGUN);
+            }
+        }
+        Player player(renderer, &level);
+
+        FrameHistogram frameTimes;
+        double levelMs = 0.0, spriteMs = 0.0, bulletMs = 0.0;
+        std::uint64_t drawCalls = 0, pixels = 0;
+
+        for (int frame = -WARMUP_FRAMES; frame < frames; frame++)
+        {
+            SDL_Point camera = cameraAt(bounds, view, frame < 0 ? 0 : frame, frames);
+            level.update({camera.x, camera.y, view.w, view.h});
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            RenderStats::beginFrame(renderer);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+
+            level.render(renderer, camera.x, camera.y);
+            SDL_RenderFlush(renderer);
+            Uint64 levelEnd = SDL_GetPerformanceCounter();
+
+            for (auto &enemy : enemies)
+                enemy->render(renderer, camera.x, camera.y);
+            player.render(renderer, camera.x, camera.y);
+            SDL_RenderFlush(renderer);
+            Uint64 spriteEnd = SDL_GetPerformanceCounter();
+
+            for (auto &bullet : bullets)
+                bullet.render(renderer, camera.x, camera.y);
+            SDL_RenderPresent(renderer);
+            Uint64 end = SDL_GetPerformanceCounter();
+
+            if (frame < 0)
+                continue;
+            frameTimes.record(elapsedMs(start, end));
+            levelMs += elapsedMs(start, levelEnd);
+            spriteMs += elapsedMs(levelEnd, spriteEnd);
+            bulletMs += elapsedMs(spriteEnd, end);
+            drawCalls += RenderStats::getFrame().drawCalls;
+            pixels += RenderStats::getFrame().pixels;
+        }
+
+        std::printf("%-26s %5dx%-5d %8.3f %8.3f %8.3f %8.3f %8.3f %8.1f %9.2f\n",
+                    mapPath, view.w, view.h, frameTimes.getMean(), frameTimes.percentile(0.95),
+                    levelMs / frames, spriteMs / frames, bulletMs / frames,
+                    static_cast<double>(drawCalls) / frames, pixels / 1e6 / frames);
+    }
+
+    bool parseResolution(const char *text, Resolution &resolution)
+    {
+        return std::sscanf(text, "%dx%d", &resolution.w, &resolution.h) == 2 && resolution.w > 0 && resolution.h > 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<Resolution> resolutions;
+    int enemyCount = 50;
+    int frames = 600;
+    for (int i = 1; i < argc; i++)
+    {
+        Resolution resolution;
+        if (std::strcmp(argv[i], "--enemies") == 0 && i + 1 < argc)
+            enemyCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (parseResolution(argv[i], resolution))
+            resolutions.push_back(resolution);
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [WxH ...] [--enemies N] [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (resolutions.empty())
+        resolutions = {{640, 360}, {1280, 720}, {1920, 1080}};
+    if (frames < 1)
+        frames = 1;
+
+    std::printf("Software renderer, %d enemies, %d frames per run (times in ms, Mpx = megapixels)\n",
+                enemyCount, frames);
+    std::printf("%-26s %11s %8s %8s %8s %8s %8s %8s %9s\n",
+                "map", "resolution", "mean", "p95", "level", "sprites", "bullets", "draws", "Mpx");
+
+    for (const Resolution &resolution : resolutions)
+    {
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, resolution.w, resolution.h, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer *renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        if (!renderer)
+        {
+            std::fprintf(stderr, "No software renderer at %dx%d: %s\n", resolution.w, resolution.h, SDL_GetError());
+            SDL_FreeSurface(surface);
+            return 1;
+        }
+
+        for (const char *mapPath : MAPS)
+            benchMap(renderer, resolution, mapPath, enemyCount, frames);
+
+        // Textures belong to this renderer.
+        ResourceManager::clear();
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+    }
+
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,137 @@
+// WeaponDispatchBench.cpp
+// Compares the old virtual weapon dispatch (heap-allocated objects behind an
+// abstract base, plus a dynamic_cast for the melee attack check) against the
+// value-based Weapon variant dispatched with std::visit.
+#define SDL_MAIN_HANDLED
+#include "EventBus.h"
+#include "Weapon.h"
+#include "Constants.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const int WEAPON_COUNT = 100000;
+    const int FRAMES = 60;
+
+    // Mirror of the former AbstractWeapon interface, reduced to the calls made per frame.
+    class VirtualWeapon
+    {
+    public:
+        virtual ~VirtualWeapon() = default;
+        virtual void shoot(std::vector<Bullet> &bullets, float x, float y, float aimX, float aimY) = 0;
+        virtual void update() = 0;
+        virtual bool isMelee() const = 0;
+    };
+
+    class VirtualProjectile : public VirtualWeapon
+    {
+    public:
+        VirtualProjectile() : weapon(WeaponType::PISTOL, -1, WEAPON_FIRE_RATE_PISTOL, WEAPON_BULLET_SPEED_PISTOL, 10) {}
+        void shoot(std::vector<Bullet> &bullets, float x, float y, float aimX, float aimY) override { weapon.shoot(bullets, x, y, aimX, aimY, nullptr, EventTarget::PLAYER); }
+        void update() override { weapon.update(); }
+        bool isMelee() const override { return false; }
+
+    private:
+        ProjectileWeapon weapon;
+    };
+
+    class VirtualMelee : public VirtualWeapon
+    {
+    public:
+        VirtualMelee() : weapon(WeaponType::KNIFE, WEAPON_FIRE_RATE_MELEE, 5) {}
+        void shoot(std::vector<Bullet> &bullets, float x, float y, float aimX, float aimY) override { weapon.shoot(bullets, x, y, aimX, aimY, nullptr, EventTarget::PLAYER); }
+        void update() override { weapon.update(); }
+        bool isMelee() const override { return true; }
+        bool isCurrentlyAttacking() const { return weapon.isAttacking(); }
+
+    private:
+        MeleeWeapon weapon;
+    };
+
+    // The attack check PlayerWeapons::isAttacking used to perform every frame.
+    bool virtualIsAttacking(const VirtualWeapon &weapon)
+    {
+        if (weapon.isMelee())
+        {
+            const VirtualMelee *mw = dynamic_cast<const VirtualMelee *>(&weapon);
+            if (mw)
+                return mw->isCurrentlyAttacking();
+        }
+        return false;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    std::vector<Bullet> bullets;
+    bullets.reserve(WEAPON_COUNT);
+
+    // Old path: one heap allocation per weapon, called through the vtable.
+    std::vector<std::unique_ptr<VirtualWeapon>> virtualWeapons;
+    virtualWeapons.reserve(WEAPON_COUNT);
+    for (int i = 0; i < WEAPON_COUNT; i++)
+    {
+        if (i % 2 == 0)
+            virtualWeapons.push_back(std::make_unique<VirtualProjectile>());
+        else
+            virtualWeapons.push_back(std::make_unique<VirtualMelee>());
+    }
+
+    // New path: weapons stored contiguously by value.
+    std::vector<Weapon> variantWeapons;
+    variantWeapons.reserve(WEAPON_COUNT);
+    for (int i = 0; i < WEAPON_COUNT; i++)
+    {
+        if (i % 2 == 0)
+            variantWeapons.emplace_back(ProjectileWeapon(WeaponType::PISTOL, -1, WEAPON_FIRE_RATE_PISTOL, WEAPON_BULLET_SPEED_PISTOL, 10));
+        else
+            variantWeapons.emplace_back(MeleeWeapon(WeaponType::KNIFE, WEAPON_FIRE_RATE_MELEE, 5));
+    }
+
+    long attackingVirtual = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        bullets.clear();
+        for (auto &weapon : virtualWeapons)
+        {
+            if (frame % 30 == 0)
+                weapon->shoot(bullets, 0.0f, 0.0f, 1.0f, 1.0f);
+            weapon->update();
+            attackingVirtual += virtualIsAttacking(*weapon);
+        }
+    }
+    double virtualMs = elapsedMs(start);
+
+    long attackingVariant = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        bullets.clear();
+        for (auto &weapon : variantWeapons)
+        {
+            if (frame % 30 == 0)
+                weapon.shoot(bullets, 0.0f, 0.0f, 1.0f, 1.0f, nullptr, EventTarget::PLAYER);
+            weapon.update();
+            attackingVariant += weapon.isAttacking();
+        }
+    }
+    double variantMs = elapsedMs(start);
+
+    const double updates = static_cast<double>(WEAPON_COUNT) * FRAMES;
+    std::printf("weapon updates per frame: %d, frames: %d\n", WEAPON_COUNT, FRAMES);
+    std::printf("virtual: %8.3f ms total, %6.2f ns/update (attacking %ld)\n",
+                virtualMs, virtualMs * 1e6 / updates, attackingVirtual);
+    std::printf("variant: %8.3f ms total, %6.2f ns/update (attacking %ld)\n",
+                variantMs, variantMs * 1e6 / updates, attackingVariant);
+    std::printf("speedup: %.2fx\n", virtualMs / variantMs);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// AssetLoader.h
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Decodes image files into SDL_Surfaces on a pool of worker threads, through
+// PixelCache, so warm starts only map previously decoded pixels.
+// Surfaces are handed back to the render thread, which turns them into
+// textures (SDL textures must be created on the thread owning the renderer).
+class AssetLoader
+{
+public:
+    // threadCount == 0 picks a count from the hardware concurrency.
+    explicit AssetLoader(unsigned threadCount = 0);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader &) = delete;
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    // Queue path for decoding. Requests for a path already queued, in flight
+    // or finished but not yet taken are ignored.
+    void request(const std::string &path);
+
+    // Non-blocking: true once path has been decoded (or failed to decode).
+    bool isReady(const std::string &path) const;
+
+    // Blocks until path is decoded and returns the surface, transferring
+    // ownership to the caller (free it with PixelCache::freeSurface).
+    // Returns nullptr on failure or if path was never requested.
+    SDL_Surface *take(const std::string &path);
+
+    // Non-blocking: moves up to maxCount finished decodes into out.
+    // Failed decodes are reported with a null surface.
+    void collect(std::vector<std::pair<std::string, SDL_Surface *>> &out, size_t maxCount);
+
+private:
+    enum class JobState
+    {
+        QUEUED,
+        DECODING,
+        DONE
+    };
+
+    struct Job
+    {
+        JobState state;
+        SDL_Surface *surface;
+    };
+
+    void workerLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable jobFinished;
+    std::deque<std::string> queue;
+    std::unordered_map<std::string, Job> jobs;
+    std::deque<std::string> finished; // Decode order, for collect().
+    std::vector<std::thread> workers;
+    bool stopping;
+};
+
+#endif // ASSET_LOADER_H
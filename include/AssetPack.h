@@ -0,0 +1,82 @@
+// AssetPack.h
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL2/SDL_rwops.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only archive of game assets, memory-mapped when mounted.
+//
+// Layout: a PackHeader, then entryCount PackEntry records sorted by path
+// hash, then the path strings, then the file contents (16-byte aligned).
+// Lookups binary-search the index in place and hand out pointers into the
+// mapping, so nothing is copied until a caller asks for it.
+//
+// When no pack is mounted, or a path is not in it, every accessor falls back
+// to the loose file on disk. Only open() touches SDL, so tools can use the
+// rest without linking it.
+class AssetPack
+{
+public:
+    static const std::uint32_t VERSION = 1;
+
+    // Maps packPath. Returns false (and keeps using loose files) if it is
+    // missing or malformed. Must not be called while asset threads are running.
+    static bool mount(const std::string &packPath);
+    static void unmount();
+    static bool isMounted() { return mapping != nullptr; }
+
+    // Finds path in the mounted pack. The returned bytes stay valid until unmount().
+    static bool find(const std::string &path, const char *&data, size_t &size);
+
+    // Copies path's contents into out, from the pack or from disk.
+    static bool read(const std::string &path, std::vector<char> &out);
+
+    // Opens path for SDL (e.g. IMG_Load_RW): a read-only view of the mapping
+    // when packed, the loose file otherwise. Returns nullptr if neither exists.
+    static SDL_RWops *open(const std::string &path)
+    {
+        const char *data;
+        size_t size;
+        if (find(path, data, size))
+            return SDL_RWFromConstMem(data, static_cast<int>(size));
+        return SDL_RWFromFile(path.c_str(), "rb");
+    }
+
+    // Writes a pack holding files (stored under the given paths) to packPath.
+    // The pack is written to a temporary file and renamed into place, so a
+    // running game never sees a half-written pack.
+    static bool build(const std::string &packPath, const std::vector<std::string> &files);
+
+    // Asset paths are stored with '/' separators and no leading "./".
+    static std::string normalizePath(const std::string &path);
+
+private:
+    struct PackHeader
+    {
+        char magic[4]; // "SSPK"
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t reserved;
+    };
+
+    struct PackEntry
+    {
+        std::uint64_t hash; // hashBytes of the normalized path.
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint32_t pathOffset;
+        std::uint32_t pathLength;
+    };
+
+    static bool validate();
+
+    static const char *mapping;
+    static size_t mappingSize;
+    static const PackEntry *entries;
+    static std::uint32_t entryCount;
+};
+
+#endif // ASSET_PACK_H
@@ -24,7 +24,7 @@ public:
      * @param y Initial y position.
      * @param dx Normalized direction along the x-axis.
      * @param dy Normalized direction along the y-axis.
-     * @param speed Speed of the bullet.
+     * @param speed Speed of the bullet, in pixels per second.
      */
     Bullet(float x, float y, float dx, float dy, float speed);
 
@@ -46,8 +46,9 @@ public:
      * @param renderer SDL renderer.
      * @param cameraX Camera x offset.
      * @param cameraY Camera y offset.
+     * @param alpha How far between the previous and the current update to draw it (0..1).
      */
-    void render(SDL_Renderer *renderer, int cameraX, int cameraY);
+    void render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha = 1.0f);
 
     /**
      * @brief Indicates whether the bullet is active.
@@ -62,9 +63,18 @@ public:
     float getX() const { return x; }
     float getY() const { return y; }
     void deactivate() { active = false; }
+    // Draw at the current position on the next frame instead of blending.
+    void resetInterpolation()
+    {
+        prevX = x;
+        prevY = y;
+    }
 
 private:
+    friend class SaveGame;
+
     float x, y;
+    float prevX, prevY; // Position before the last update, for interpolation.
     float dx, dy; // Normalized direction vector.
     float speed;
     bool active; // True if bullet is in play; false if it has left the screen or collided.
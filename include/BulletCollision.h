@@ -0,0 +1,33 @@
+// BulletCollision.h
+#ifndef BULLET_COLLISION_H
+#define BULLET_COLLISION_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+#include "Bullet.h"
+#include "CollisionGrid.h"
+#include "Enemy.h"
+#include "EventBus.h"
+
+// The bullet part of a simulation tick, kept apart from Game so it can be
+// run (and benchmarked) on its own. Hits are reported as damage events;
+// bullets that hit something are deactivated and removed by removeInactive().
+class BulletCollision
+{
+public:
+    // Advances every bullet by dt seconds.
+    static void move(std::vector<Bullet> &bullets, float dt);
+
+    // Enemy bullets against the walls and the player's collision box.
+    static void hitPlayer(std::vector<Bullet> &bullets, const SDL_Rect &playerBox, const CollisionGrid &walls, EventBus &events);
+
+    // Player bullets against the walls and every live enemy; a bullet stops
+    // at the first enemy it hits.
+    static void hitEnemies(std::vector<Bullet> &bullets, const std::vector<std::unique_ptr<Enemy>> &enemies,
+                           const CollisionGrid &walls, EventBus &events);
+
+    static void removeInactive(std::vector<Bullet> &bullets);
+};
+
+#endif // BULLET_COLLISION_H
@@ -0,0 +1,77 @@
+// ChunkStreamer.h
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "LevelFormat.h"
+
+// Keeps the chunks of an infinite map resident around the camera. Chunks
+// overlapping the view (plus loadMargin chunks on each side) are decoded on a
+// worker thread; chunks more than evictMargin chunks outside the view are
+// dropped, baked texture included. Memory therefore depends on the view
+// size, not on the map size.
+//
+// Everything except the decoding runs on the main thread.
+class ChunkStreamer
+{
+public:
+    struct ResidentChunk
+    {
+        LevelChunk chunk;
+        SDL_Texture *baked = nullptr; // Filled in by Level when drawn.
+        bool bakeFailed = false;
+    };
+
+    ChunkStreamer(const LevelData &data, int loadMargin, int evictMargin);
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer &) = delete;
+    ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+
+    // Requests and evicts chunks for the given view (world pixels) and adopts
+    // finished decodes. The first call decodes the visible chunks before
+    // returning, so a level never starts without its walls.
+    // Returns true if the resident set changed.
+    bool update(const SDL_Rect &view);
+
+    const std::map<std::pair<int, int>, std::unique_ptr<ResidentChunk>> &getResidentChunks() const { return resident; }
+
+    // Decoded tile data and baked textures currently held.
+    size_t getMemoryUsage() const;
+
+private:
+    using ChunkKey = std::pair<int, int>; // (y, x), matching LevelData::chunks.
+
+    void workerLoop();
+    bool adoptFinished();
+    static void destroyChunk(ResidentChunk &chunk);
+
+    const LevelData &data;
+    int chunkWidth, chunkHeight; // In pixels.
+    int loadMargin;
+    int evictMargin;
+    bool primed = false;
+
+    // Main thread only.
+    std::map<ChunkKey, std::unique_ptr<ResidentChunk>> resident;
+    std::map<ChunkKey, const ChunkRecord *> requested;
+
+    // Shared with the worker.
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable chunkFinished;
+    std::deque<const ChunkRecord *> queue;
+    std::vector<LevelChunk> finished;
+    bool stopping = false;
+    std::thread worker;
+};
+
+#endif // CHUNK_STREAMER_H
@@ -0,0 +1,45 @@
+// CollisionGrid.h
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Static wall rectangles bucketed into a uniform grid, so an overlap query
+// only tests the walls in the cells the query box touches instead of every
+// wall in the level. Cells are stored in CSR form: the rect indices of cell i
+// are cellItems[cellStart[i] .. cellStart[i + 1]).
+class CollisionGrid
+{
+public:
+    static const int DEFAULT_CELL_SIZE = 64;
+
+    void build(std::vector<SDL_Rect> rects, int cellSize = DEFAULT_CELL_SIZE);
+
+    // Returns true if box overlaps any wall.
+    bool intersects(const SDL_Rect &box) const;
+
+    const std::vector<SDL_Rect> &getRects() const { return rects; }
+    size_t getMemoryFootprint() const;
+
+private:
+    friend class LevelFormat; // Reads and writes the raw layout for cooked levels.
+
+    // Same semantics as SDL_HasIntersection, inlined for the query loop.
+    static bool overlaps(const SDL_Rect &a, const SDL_Rect &b)
+    {
+        return a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+               a.x < b.x + b.w && b.x < a.x + a.w &&
+               a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+
+    std::vector<SDL_Rect> rects;
+    int cellSize = DEFAULT_CELL_SIZE;
+    int originX = 0, originY = 0;
+    int columns = 0, rows = 0;
+    std::vector<std::uint32_t> cellStart;
+    std::vector<std::uint32_t> cellItems;
+};
+
+#endif // COLLISION_GRID_H
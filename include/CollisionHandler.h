@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include "CollisionGrid.h"
 
 class CollisionHandler
 {
@@ -17,6 +18,12 @@ public:
         }
         return false;
     }
+
+    // Same check against a level's bucketed walls.
+    static bool checkCollision(const SDL_Rect &box, const CollisionGrid &walls)
+    {
+        return walls.intersects(box);
+    }
 };
 
 #endif // COLLISION_HANDLER_H
@@ -1,6 +1,8 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <cstddef>
+
 // Screen settings
 const int SCREEN_WIDTH = 1200;
 const int SCREEN_HEIGHT = 768;
@@ -14,6 +16,19 @@ const int PLAYER_COLLISION_WIDTH = 16;
 const int PLAYER_COLLISION_HEIGHT = 16;
 const float PLAYER_SPEED = 3.0f;
 
+// Simulation: gameplay advances in fixed ticks, independent of the render
+// rate, and rendering interpolates between the last two ticks. Animation
+// frame counters and player movement are tuned per tick, so changing the
+// rate changes the game's pace.
+const int SIMULATION_HZ = 60;
+const float FIXED_TIMESTEP = 1.0f / SIMULATION_HZ;
+const int FALLBACK_REFRESH_RATE = 60; // Pacing target when vsync and the display rate are both unavailable.
+const float MAX_FRAME_TIME = 0.25f; // Longer frames are clamped so a stall does not fast-forward.
+const long HEADLESS_DEFAULT_TICKS = 60 * SIMULATION_HZ; // --headless without --ticks or a replay.
+const unsigned long long HEADLESS_SEED = 1;
+const long STRESS_DEFAULT_TICKS = 10 * SIMULATION_HZ; // Per population step of --stress.
+const unsigned long long STRESS_SEED = 1;
+
 // Animation settings
 const int ANIMATION_FRAME_SPEED = 3;
 const int IDLE_FRAMES = 1;
@@ -27,6 +42,26 @@ const int MENU_START_Y = 250;
 const int MENU_SPACING = 100;
 const int MENU_CENTER_X = (SCREEN_WIDTH - BUTTON_WIDTH) / 2;
 
+// Asset loading
+const char *const ASSET_PACK_PATH = "assets.pak"; // Built by `make pack`; optional.
+const char *const PIXEL_CACHE_DIR = "cache/pixels"; // Decoded images, written on first run.
+const int TEXTURE_UPLOADS_PER_FRAME = 4; // Background-decoded textures created per rendered frame.
+const char *const QUICKSAVE_PATH = "quicksave.sav";
+const char *const PROFILE_TRACE_PATH = "trace.json"; // F10 in debug builds; see Profiler.h.
+const size_t TEXTURE_MEMORY_BUDGET = 128 * 1024 * 1024; // Unreferenced textures beyond this are evicted.
+
+// Level preloading: how many upcoming levels may be held in memory, and the
+// byte budget for their parsed data plus decoded tileset textures.
+const int PRELOAD_MAX_LEVELS = 1;
+const size_t PRELOAD_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+// Infinite maps: chunks within CHUNK_LOAD_MARGIN chunks of the view are
+// streamed in, chunks beyond CHUNK_EVICT_MARGIN are dropped, and at most
+// CHUNK_BAKES_PER_FRAME chunks are baked into textures per frame.
+const int CHUNK_LOAD_MARGIN = 1;
+const int CHUNK_EVICT_MARGIN = 2;
+const int CHUNK_BAKES_PER_FRAME = 2;
+
 // Level settings
 const int DEFAULT_TILE_WIDTH = 32;
 const int DEFAULT_TILE_HEIGHT = 32;
@@ -35,12 +70,12 @@ const int DEFAULT_TILE_HEIGHT = 32;
 // Pistol
 const int WEAPON_AMMO_PISTOL = 10;
 const float WEAPON_FIRE_RATE_PISTOL = 0.5f;
-const float WEAPON_BULLET_SPEED_PISTOL = 12.0f;
+const float WEAPON_BULLET_SPEED_PISTOL = 720.0f; // Pixels per second.
 
 // Shotgun
 const int WEAPON_AMMO_SHOTGUN = 5;
 const float WEAPON_FIRE_RATE_SHOTGUN = 1.0f;
-const float WEAPON_BULLET_SPEED_SHOTGUN = 10.0f;
+const float WEAPON_BULLET_SPEED_SHOTGUN = 600.0f;
 
 // Melee weapons (Barefist, Baseball Bat, Knife)
 const int WEAPON_AMMO_MELEE = -1; // -1 indicates unlimited ammo for melee
@@ -50,6 +85,9 @@ const float WEAPON_BULLET_SPEED_MELEE = 0.0f;
 // Default (for any other weapon)
 const int WEAPON_AMMO_DEFAULT = 20;
 const float WEAPON_FIRE_RATE_DEFAULT = 0.2f;
-const float WEAPON_BULLET_SPEED_DEFAULT = 14.0f;
+const float WEAPON_BULLET_SPEED_DEFAULT = 840.0f;
+
+// Bullets are drawn and collide as a square of this size.
+const int BULLET_SIZE = 5;
 
 #endif // CONSTANTS_H
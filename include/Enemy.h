@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include <optional>
 #include "Constants.h"
 #include "CollisionHandler.h"
 #include "Weapon.h"
@@ -25,14 +26,18 @@ public:
     //  - dt: Delta time (in seconds)
     //  - playerRect: Player's on-screen rectangle (for detection)
     //  - walls: Collision boundaries for patrolling
-    void update(float dt, const SDL_Rect &playerRect, const std::vector<SDL_Rect> &walls, std::vector<Bullet> &enemyBullets, bool playerAlive);
+    //  - events: Receives a shot event for every bullet the enemy fires
+    void update(float dt, const SDL_Rect &playerRect, const CollisionGrid &walls, std::vector<Bullet> &enemyBullets,
+                EventBus &events, bool playerAlive);
 
     // Render the enemy (alive or dead) with its current animation and facing angle.
-    // cameraX/Y are world-to-screen offsets.
-    void render(SDL_Renderer *renderer, int cameraX, int cameraY);
+    // cameraX/Y are world-to-screen offsets; alpha is how far between the
+    // previous and the current update to draw it (0..1).
+    void render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha = 1.0f);
 
     // Inflict damage; if health drops to or below zero, enemy dies.
-    void takeDamage(int damage);
+    // Returns true only for the hit that killed the enemy.
+    bool takeDamage(int damage);
 
     // Returns true if enemy is dead.
     bool isDead() const { return state == EnemyState::DEAD; }
@@ -40,16 +45,26 @@ public:
     // Get enemy position.
     float getX() const { return x; }
     float getY() const { return y; }
+    // Draw at the current position on the next frame instead of blending.
+    void resetInterpolation()
+    {
+        prevX = x;
+        prevY = y;
+    }
 
     SDL_Rect getCollisionBox() const { return collisionBox; }
 
-    void attack(std::vector<Bullet> &enemyBullets, const SDL_Rect &playerRect);
-    std::unique_ptr<AbstractWeapon> dropWeapon();
+    void attack(std::vector<Bullet> &enemyBullets, const SDL_Rect &playerRect, EventBus &events);
+    std::optional<Weapon> dropWeapon();
 
-    bool hasWeapon() const { return (weapon != nullptr); }
+    bool hasWeapon() const { return weapon.has_value(); }
+    bool isBoss() const { return boss; }
 
 private:
-    float x, y; // World position of the enemy.
+    friend class SaveGame;
+
+    float x, y;         // World position of the enemy.
+    float prevX, prevY; // Position before the last update, for interpolation.
     SDL_Rect collisionBox;
     float speed;      // Movement speed.
     int health;       // Health points.
@@ -58,34 +73,37 @@ private:
 
     int runFrame = 0;
     int runFrameTime = 0;
-    const int RUN_FRAMES = 8;
-    const int RUN_FRAME_SPEED = 3; // Adjust as needed
+    static constexpr int RUN_FRAMES = 8;
+    static constexpr int RUN_FRAME_SPEED = 3; // Adjust as needed
 
     int deathFrame;
     int deathFrameTime;
-    const int DEATH_FRAMES = 7;
-    const int DEATH_FRAME_SPEED = 3;
+    static constexpr int DEATH_FRAMES = 7;
+    static constexpr int DEATH_FRAME_SPEED = 3;
     bool deathAnimationPlayed;
 
     int deadEffectFrame;
     int deadEffectFrameTime;
-    const int DEAD_EFFECT_FRAMES = 4;
-    const int DEAD_EFFECT_SPEED = 50;
+    static constexpr int DEAD_EFFECT_FRAMES = 4;
+    static constexpr int DEAD_EFFECT_SPEED = 50;
     int deadEffectDelayCounter;
-    const int deadEffectDelayThreshold = 30;
+    static constexpr int deadEffectDelayThreshold = 30;
 
     // Simple AI methods.
-    void patrol(float dt, const std::vector<SDL_Rect> &walls);
+    void patrol(float dt, const CollisionGrid &walls);
     void engagePlayer(const SDL_Rect &playerRect);
 
-    std::unique_ptr<AbstractWeapon> weapon;
+    std::optional<Weapon> weapon;
 
     float fireTimer = 0.0f;
 
+    TextureRef effectTexture;
+
 protected:
-    SDL_Texture *enemyIdleTexture;
-    SDL_Texture *enemyRunTexture;
-    SDL_Texture *deadTexture;
+    bool boss = false;
+    TextureRef enemyIdleTexture;
+    TextureRef enemyRunTexture;
+    TextureRef deadTexture;
 };
 
 #endif // ENEMY_H
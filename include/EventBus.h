@@ -0,0 +1,119 @@
+// EventBus.h
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <cstddef>
+#include <vector>
+#include "Weapon.h"
+
+// Who an event refers to.
+enum class EventTarget
+{
+    PLAYER,
+    ENEMY
+};
+
+// Damage dealt to the player or to the enemy at enemyIndex.
+struct DamageEvent
+{
+    EventTarget target;
+    int enemyIndex; // Index into Game::enemies; unused for the player.
+    int amount;
+};
+
+// An enemy's health dropped to zero.
+struct DeathEvent
+{
+    int enemyIndex;
+    float x, y;
+};
+
+// A weapon was put on the ground (by a dying enemy or a player throw).
+struct WeaponDroppedEvent
+{
+    WeaponType type;
+    float x, y;
+};
+
+// A projectile weapon spawned a bullet.
+struct ShotFiredEvent
+{
+    EventTarget shooter;
+    float x, y;
+};
+
+// FIFO ring buffer. Storage for InitialCapacity events is allocated up
+// front, so pushing and draining do not allocate in a normal tick; a push
+// into a full queue doubles the storage rather than dropping the event.
+template <typename T, std::size_t InitialCapacity>
+class EventQueue
+{
+public:
+    EventQueue() : items(InitialCapacity) {}
+
+    void push(const T &event)
+    {
+        if (count == items.size())
+            grow();
+        items[(head + count) % items.size()] = event;
+        count++;
+    }
+
+    // Pop every queued event in order and pass it to handler. Events pushed
+    // by the handler itself are drained in the same call.
+    template <typename Handler>
+    void drain(Handler &&handler)
+    {
+        while (count > 0)
+        {
+            T event = items[head];
+            head = (head + 1) % items.size();
+            count--;
+            handler(event);
+        }
+    }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    // Unrolls the ring into storage twice the size, oldest event first.
+    void grow()
+    {
+        std::vector<T> larger(items.empty() ? 16 : items.size() * 2);
+        for (std::size_t i = 0; i < count; i++)
+            larger[i] = items[(head + i) % items.size()];
+        items.swap(larger);
+        head = 0;
+    }
+
+    std::vector<T> items;
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+
+// Per-type event queues filled during a tick and drained once at its end by
+// the systems that care, instead of those systems polling every entity.
+struct EventBus
+{
+    EventQueue<DamageEvent, 1024> damage;
+    EventQueue<DeathEvent, 256> deaths;
+    EventQueue<WeaponDroppedEvent, 256> weaponDrops;
+    EventQueue<ShotFiredEvent, 1024> shotsFired;
+
+    void clear()
+    {
+        damage.clear();
+        deaths.clear();
+        weaponDrops.clear();
+        shotsFired.clear();
+    }
+};
+
+#endif // EVENT_BUS_H
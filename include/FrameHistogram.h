@@ -0,0 +1,39 @@
+// FrameHistogram.h
+#ifndef FRAME_HISTOGRAM_H
+#define FRAME_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Distribution of frame durations, in milliseconds. Samples go into fixed
+// 0.05 ms buckets up to 100 ms (longer ones share an overflow bucket), so
+// recording is O(1) and allocation-free; percentiles are accurate to one
+// bucket. The mean and max are exact.
+class FrameHistogram
+{
+public:
+    void record(double ms);
+    void reset();
+
+    size_t getCount() const { return count; }
+    double getMean() const { return count ? totalMs / count : 0.0; }
+    double getMax() const { return maxMs; }
+
+    // Smallest duration that fraction (0..1) of the samples do not exceed.
+    double percentile(double fraction) const;
+
+    // "N frames: mean .. p50 .. p95 .. p99 .. max .. ms", for logs.
+    std::string summary() const;
+
+private:
+    static constexpr double BUCKET_MS = 0.05;
+    static constexpr int BUCKET_COUNT = 2000;
+
+    std::array<std::uint32_t, BUCKET_COUNT + 1> buckets{}; // Last one is the overflow.
+    size_t count = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+};
+
+#endif // FRAME_HISTOGRAM_H
@@ -0,0 +1,44 @@
+// FramePacer.h
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <SDL2/SDL.h>
+#include "FrameHistogram.h"
+
+// Holds the main loop to a target frame rate and measures what it delivers.
+//
+// Deadlines are kept on the performance counter as exact multiples of the
+// frame period, so rounding never accumulates into drift. Waiting sleeps
+// with SDL_Delay until SPIN_MS before the deadline, then spins the rest:
+// SDL_Delay alone can overshoot by a millisecond or more. A frame that runs
+// more than a period late resynchronizes instead of rushing to catch up.
+//
+// With a target of 0 the pacer does not wait (vsync paces the loop) but
+// still records frame times.
+class FramePacer
+{
+public:
+    explicit FramePacer(int targetFps = 0);
+
+    void setTargetFps(int fps);
+    int getTargetFps() const { return targetFps; }
+
+    // Call once per frame, after presenting. Waits for the next deadline if
+    // a target is set, then records the time since the previous call.
+    void endFrame();
+
+    const FrameHistogram &getHistogram() const { return histogram; }
+
+private:
+    static constexpr double SPIN_MS = 1.5;
+
+    int targetFps = 0;
+    double frequency;      // Counter ticks per second.
+    double periodTicks = 0.0;
+    double nextDeadline = 0.0; // In counter ticks; 0 until the first frame.
+    Uint64 lastFrameEnd = 0;
+
+    FrameHistogram histogram;
+};
+
+#endif // FRAME_PACER_H
@@ -2,7 +2,9 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <array>
 #include <memory>
+#include <optional>
 #include "Renderer.h"
 #include "Player.h"
 #include "Level.h"
@@ -11,28 +13,121 @@
 #include "SDLDeleters.h"
 #include "Enemy.h"
 #include "BossEnemy.h"
+#include "EventBus.h"
+#include "LevelPreloader.h"
+#include "Random.h"
+#include "Replay.h"
 
 struct Camera
 {
     int x, y, w, h;
 };
 
+// Parts of Game::update() that are timed separately.
+enum class UpdateSystem
+{
+    INPUT,
+    LEVEL,
+    PLAYER,
+    ENEMIES,
+    BULLETS,
+    EVENTS,
+    REPLAY,
+    COUNT
+};
+
+// Performance-counter time spent in each UpdateSystem across ticks.
+struct UpdateTimings
+{
+    std::array<Uint64, static_cast<int>(UpdateSystem::COUNT)> counts{};
+    Uint64 ticks = 0;
+};
+
+// Populations for a stress run (see Game::runStress), spawned at seeded
+// random points on the map in place of its usual enemies.
+struct StressPopulation
+{
+    int enemies = 0;
+    int bosses = 0;
+    int bullets = 0;       // Live enemy bullets, topped up before every tick.
+    int playerBullets = 0; // Live player bullets, topped up before every tick.
+    int weapons = 0;       // Dropped weapons lying on the map.
+};
+
+// Running totals fed from the event bus.
+struct GameStats
+{
+    int kills = 0;
+    int shotsFired = 0;
+    int weaponsDropped = 0;
+};
+
+// Level state as it was right after the map was loaded, copied back over
+// the live objects on restart instead of loading the level again.
+struct LevelSnapshot
+{
+    int mapIndex = -1; // -1 while nothing has been captured.
+    std::optional<Player> player;
+    std::vector<Enemy> enemies; // Sliced copies; BossEnemy adds no state of its own.
+    std::vector<Weapon> droppedWeapons;
+};
+
 class Game
 {
 public:
     Game();
     ~Game();
 
-    bool init(const char *title, int width, int height);
+    // headless: no display or GPU needed (dummy video driver, software
+    // renderer); drive the game with runHeadless() instead of the frame loop.
+    bool init(const char *title, int width, int height, bool headless = false);
     void handleEvents();
-    void update();
-    void render();
+    void update(); // One simulation tick of FIXED_TIMESTEP seconds.
+    // alpha: fraction of a tick elapsed since the last update(), used to
+    // interpolate positions between the previous and the current tick.
+    void render(float alpha = 1.0f);
     void clean();
     bool isRunning() const;
+    void setVSync(bool enabled) { renderer->setVSync(enabled); }
+    bool hasVSync() const { return renderer->hasVSync(); }
+    // Refresh rate of the display showing the window, or 0 if unknown.
+    int getRefreshRate() const;
+
+    // Skip the menu and play mapFiles[currentMapIndex] with a fresh seed,
+    // recording every tick; the replay is written to path by clean().
+    bool startRecording(const std::string &path);
+    // Skip the menu and play back a recording; the game stops at its end.
+    bool startReplay(const std::string &path);
+
+    // Runs the started replay, or tickCount ticks of the current map, as
+    // fast as possible without rendering, then logs ticks per second and
+    // the time per tick of each part of update(). Returns false if a replay
+    // desynced.
+    bool runHeadless(long tickCount);
+    size_t getReplayTick() const { return replay.getTick(); }
+
+    // Plays map mapIndex headless `steps` times with no input, populated
+    // with `largest` on the last run and half as much on each run before
+    // it, for ticksPerStep ticks each. Logs the tick time per population
+    // and writes one CSV row per run to csvPath, for scaling curves.
+    bool runStress(const StressPopulation &largest, int steps, long ticksPerStep, int mapIndex, const std::string &csvPath);
+
+    // Draws the current tick with every queued texture uploaded and returns
+    // it as an ARGB8888 surface the caller frees, or nullptr on failure.
+    // Unlike render(), the output depends only on the game state.
+    SDL_Surface *captureFrame();
 
 private:
+    friend class SaveGame;
+
     bool createWindowAndRenderer(const char *title, int width, int height);
-    void processGameInput(SDL_Event &event); // New: dedicated game input handler
+    // Everything render() does short of presenting.
+    void drawFrame(float alpha);
+    // Input for one tick: presses queued by handleEvents() since the last
+    // tick plus held keys and aim sampled now.
+    InputCommand collectInput();
+    void applyInput(const InputCommand &command);
+    InputCommand pendingInput;
 
     std::unique_ptr<SDL_Window, SDLWindowDeleter> window;
     std::unique_ptr<Renderer> renderer;
@@ -48,23 +143,68 @@ private:
     bool returnToMainMenu;
 
     Camera camera;
+    SDL_Point previousCamera = {0, 0}; // Camera position before the last tick.
 
     std::vector<std::unique_ptr<Enemy>> enemies;
 
     void spawnEnemies(SDL_Renderer *renderer);
+    // Stress runs only; see runStress().
+    std::optional<StressPopulation> stressPopulation;
+    void spawnStressPopulation(SDL_Renderer *renderer);
+    void topUpStressBullets();
+    bool randomOpenPoint(float &x, float &y);
     void updateEnemies(float dt);
-    void renderEnemies(SDL_Renderer *renderer, int cameraX, int cameraY);
+    void renderEnemies(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha);
 
     std::vector<Bullet> enemyBullets;
 
-    std::vector<std::unique_ptr<AbstractWeapon>> droppedWeapons;
+    std::vector<Weapon> droppedWeapons;
+
+    // Gameplay events queued during a tick and drained by processEvents().
+    EventBus events;
+    GameStats stats;
+    int aliveEnemies;
+    void processEvents();
 
     // New members for level progression.
     std::vector<std::string> mapFiles;
     int currentMapIndex;
+    int levelMapIndex = -1; // Map that level was loaded from.
 
     // New method to restart the current level.
     void restartLevel(SDL_Renderer *sdlRenderer);
+
+    LevelSnapshot snapshot;
+    void captureSnapshot();
+    bool restoreSnapshot();
+
+    // Gameplay randomness; saved with the game so a quickload replays the same.
+    Random rng;
+
+    // Recording and playback; see startRecording() / startReplay().
+    Replay replay;
+    std::string recordPath;
+    Uint64 replayStart = 0;
+    std::vector<char> checksumBuffer;
+    // Hash of the simulation state (what a save holds), checked every tick.
+    std::uint32_t stateChecksum();
+    // Starts from a known state: seed, map, camera at the origin, no stats.
+    void beginSession(std::uint64_t seed, int mapIndex);
+    void finishReplay();
+
+    bool headless = false;
+    UpdateTimings updateTimings;
+    void logUpdateTimings() const;
+
+    // F5 / F9: write or load QUICKSAVE_PATH.
+    void quickSave();
+    void quickLoad();
+    // Makes the next frame draw the camera and every entity where they are
+    // now, with nothing blended from the previous tick.
+    void resetInterpolation();
+
+    // Parses the next map and decodes its tilesets in the background.
+    LevelPreloader preloader;
 };
 
 #endif // GAME_H
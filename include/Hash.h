@@ -0,0 +1,21 @@
+// Hash.h
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit FNV-1a. Used for content hashes and path lookups in on-disk formats,
+// so its output must never change.
+inline std::uint64_t hashBytes(const char *bytes, size_t size)
+{
+    std::uint64_t value = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        value ^= static_cast<unsigned char>(bytes[i]);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+#endif // HASH_H
@@ -0,0 +1,49 @@
+// InputCommand.h
+#ifndef INPUT_COMMAND_H
+#define INPUT_COMMAND_H
+
+#include <array>
+#include <cstdint>
+
+// Edge-triggered player actions.
+enum class InputAction
+{
+    FIRE,    // Left click: shoot or swing.
+    USE,     // Right click: throw the held weapon or pick one up.
+    RESTART, // R: restart the level once the player is dead.
+    COUNT
+};
+
+// Where and when an action was pressed. x/y is the world point under the
+// cursor at the time of a click (unused for keys), timestamp the event's
+// SDL_GetTicks() time.
+struct InputPress
+{
+    float x = 0.0f, y = 0.0f;
+    std::uint32_t timestamp = 0;
+};
+
+// Everything the player asked for during one simulation tick. Held state
+// (movement, aim) is sampled once at the start of the tick; presses are
+// collected from the events since the previous tick. Game applies exactly
+// one command per tick, so a command stream reproduces a session.
+//
+// Plain data with no pointers, so it can be copied, stored and sent as is.
+struct InputCommand
+{
+    std::int8_t moveX = 0, moveY = 0; // -1, 0 or 1 per axis.
+    float aimX = 0.0f, aimY = 0.0f;   // World point under the cursor.
+
+    std::uint8_t pressed = 0; // Bit per InputAction.
+    std::array<InputPress, static_cast<int>(InputAction::COUNT)> presses;
+
+    bool wasPressed(InputAction action) const { return pressed & (1u << static_cast<int>(action)); }
+    const InputPress &press(InputAction action) const { return presses[static_cast<int>(action)]; }
+    void setPressed(InputAction action, const InputPress &at)
+    {
+        pressed |= 1u << static_cast<int>(action);
+        presses[static_cast<int>(action)] = at;
+    }
+};
+
+#endif // INPUT_COMMAND_H
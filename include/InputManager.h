@@ -2,14 +2,23 @@
 #define INPUT_MANAGER_H
 
 #include <SDL2/SDL.h>
+#include "InputCommand.h"
 
+// Translates SDL input into InputCommands, and commands into movement.
 class InputManager
 {
 public:
-    // Processes input keys and updates velocity and moving flag.
-    // The speed values are set here; you might want to parameterize these or
-    // use a constant defined elsewhere.
-    static void processInput(const Uint8 *keys, float &velX, float &velY, bool &isMoving);
+    // Fills the command's held state (movement keys, aim) from the current
+    // keyboard and mouse state. cameraX/Y turn the cursor into world coordinates.
+    static void sampleHeld(InputCommand &command, int cameraX, int cameraY);
+
+    // Records event into the command if it is an action press (mouse
+    // buttons, R), using the cursor position and time of the event.
+    // Returns false for events that are not player actions.
+    static bool recordPress(InputCommand &command, const SDL_Event &event, int cameraX, int cameraY);
+
+    // Turns the command's movement into a velocity and moving flag.
+    static void processInput(const InputCommand &command, float &velX, float &velY, bool &isMoving);
 };
 
 #endif // INPUT_MANAGER_H
@@ -2,56 +2,53 @@
 #define LEVEL_H
 
 #include <SDL2/SDL.h>
+#include <memory>
 #include <vector>
 #include <string>
-#include <memory>
-#include "json.hpp"
-#include "SDLDeleters.h"
-
-using json = nlohmann::json;
-
-// Encapsulated tile layer data.
-struct TileLayer
-{
-    std::string name;
-    int width;
-    int height;
-    std::vector<std::vector<int>> tiles;
-    std::vector<std::vector<SDL_RendererFlip>> flipFlags;
-    std::vector<std::vector<double>> rotationAngles;
-};
-
-struct Tileset
-{
-    int firstGid;
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> texture;
-    int tileWidth, tileHeight;
-    int columns;
-};
+#include "ChunkStreamer.h"
+#include "LevelFormat.h"
+#include "ResourceManager.h"
 
 class Level
 {
 public:
+    // Loads the map (cooked file if current, JSON otherwise). Makes no SDL
+    // calls, so it may run on a worker thread.
+    explicit Level(const std::string &filename);
+    // Loads the map and its textures.
     Level(SDL_Renderer *renderer, const std::string &filename);
     ~Level();
 
+    // Acquires the tileset textures. Must run on the render thread.
+    void loadTextures(SDL_Renderer *renderer);
+
+    // Streams the chunks of infinite maps in and out around view (world
+    // pixels) and refreshes the collision grid when they change. No-op for
+    // finite maps. Call once per tick after moving the camera.
+    void update(const SDL_Rect &view);
+
     void render(SDL_Renderer *renderer, int cameraX, int cameraY);
-    const std::vector<SDL_Rect> &getCollisionTiles() const { return collisionTiles; }
+
+    const std::vector<SDL_Rect> &getCollisionTiles() const { return data.collision.getRects(); }
+    const CollisionGrid &getCollisionGrid() const { return data.collision; }
+    std::vector<std::string> getTilesetImages() const;
+
+    // World-pixel extent of the map: its layers, or every chunk of an infinite map.
+    SDL_Rect getBounds() const;
+
+    // Approximate memory held by the parsed map data and, for infinite maps,
+    // the resident chunks and their baked textures (tileset textures excluded).
+    size_t getMemoryFootprint() const;
 
 private:
-    SDL_Renderer *renderer;
-    std::vector<Tileset> tilesets;
-    std::vector<TileLayer> tileLayers;    // Now using encapsulated TileLayer struct.
-    std::vector<SDL_Rect> collisionTiles; // Separate collision data.
-
-    void loadFromFile(const std::string &filename);
-    bool loadTileset(const json &tilesetJson);
-    Tileset *getTilesetForTileID(int tileID);
-
-    // New: Loads a tile layer from JSON.
-    TileLayer loadTileLayer(const json &layerJson, int defaultTileWidth, int defaultTileHeight);
-    // New: Generates collision tiles from a tile layer.
-    void generateCollisionTilesForLayer(const TileLayer &layer, int defaultTileWidth, int defaultTileHeight);
+    LevelData data;
+    std::vector<TextureRef> tilesetTextures; // Parallel to data.tilesets; empty until loadTextures.
+    std::unique_ptr<ChunkStreamer> streamer; // Infinite maps only.
+    int bakeMargin = 0;                      // Room around a baked chunk for tiles drawn past its edge.
+
+    // Draws layer with its top-left tile cell at (originX, originY) on the render target.
+    void drawLayer(SDL_Renderer *renderer, const TileLayer &layer, int originX, int originY);
+    void bakeChunk(SDL_Renderer *renderer, ChunkStreamer::ResidentChunk &chunk);
 };
 
 #endif // LEVEL_H
@@ -0,0 +1,126 @@
+// LevelFormat.h
+#ifndef LEVEL_FORMAT_H
+#define LEVEL_FORMAT_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CollisionGrid.h"
+
+// Per-tile transform byte: the low two bits are SDL_RendererFlip flags, the
+// next two select a rotation decoded from Tiled's diagonal flip.
+const std::uint8_t TILE_ROTATE_90 = 0x4;
+const std::uint8_t TILE_ROTATE_270 = 0x8;
+
+inline SDL_RendererFlip tileFlip(std::uint8_t transform)
+{
+    return static_cast<SDL_RendererFlip>(transform & (SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL));
+}
+
+inline double tileRotation(std::uint8_t transform)
+{
+    if (transform & TILE_ROTATE_90)
+        return 90.0;
+    if (transform & TILE_ROTATE_270)
+        return 270.0;
+    return 0.0;
+}
+
+// Marks a cell with no tile in TileLayer::tilesetIndex.
+const std::uint16_t NO_TILESET = 0xFFFF;
+
+// Encapsulated tile layer data, packed row-major (index = y * width + x).
+struct TileLayer
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    bool collision = false;              // Walls/windows generate collision rects.
+    std::vector<std::uint32_t> tiles;        // Tile GIDs with the flip bits stripped.
+    std::vector<std::uint8_t> transforms;    // See tileFlip/tileRotation.
+    std::vector<std::uint16_t> tilesetIndex; // Tileset owning each tile, or NO_TILESET.
+};
+
+struct TilesetInfo
+{
+    int firstGid;
+    std::string imagePath;
+    int tileWidth, tileHeight;
+    int columns;
+};
+
+// One chunk of an infinite map. Its raw GIDs live in LevelData::chunkTiles
+// at offset: one chunkSize x chunkSize block per layer, in layer order.
+struct ChunkRecord
+{
+    std::int32_t x, y; // Chunk coordinates (tile coordinates / chunkSize).
+    std::uint64_t offset;
+};
+
+// A decoded chunk, ready to collide with and draw.
+struct LevelChunk
+{
+    int x = 0, y = 0;
+    std::vector<TileLayer> layers;        // chunkSize x chunkSize each.
+    std::vector<SDL_Rect> collisionRects; // World coordinates.
+};
+
+// Everything a Level needs from its map file, independent of any renderer.
+//
+// Finite maps hold their tiles in layers and their walls in collision.
+// Infinite (chunked) maps only keep their raw GIDs in chunkTiles; layers
+// carry just names and collision flags, and chunks are decoded on demand with
+// LevelFormat::loadChunk.
+struct LevelData
+{
+    int tileWidth = 0;
+    int tileHeight = 0;
+    std::vector<TilesetInfo> tilesets;
+    std::vector<TileLayer> layers;
+    CollisionGrid collision;
+
+    bool infinite = false;
+    int chunkSize = 0;                     // Tiles per chunk side.
+    std::vector<ChunkRecord> chunks;       // Sorted by (y, x).
+    std::vector<std::uint32_t> chunkTiles; // Raw GIDs, flip bits included.
+
+    const ChunkRecord *findChunk(int x, int y) const;
+    size_t getMemoryFootprint() const;
+};
+
+// Loads maps either from Tiled JSON or from a cooked binary blob produced by
+// the mapc tool. The cooked file sits next to the JSON with a .lvl
+// extension, stores a hash of the JSON it was built from, and holds the
+// packed layers, resolved tileset indices, collision rects and collision grid,
+// so loading it is one file read plus array copies.
+class LevelFormat
+{
+public:
+    static const std::uint32_t COOKED_VERSION = 3;
+
+    // Loads jsonPath, preferring its cooked file when that is present and
+    // was built from the current JSON contents.
+    static bool load(const std::string &jsonPath, LevelData &out);
+
+    // Parses Tiled JSON text in one streaming pass (no JSON DOM).
+    static bool parseJson(const char *text, size_t size, LevelData &out);
+
+    // Decodes a cooked blob. Fails if the blob is malformed, has another
+    // version, or was cooked from a source whose hash is not sourceHash.
+    static bool readCooked(const std::vector<char> &blob, std::uint64_t sourceHash, LevelData &out);
+    static bool writeCooked(const std::string &cookedPath, const LevelData &data, std::uint64_t sourceHash);
+
+    // Decodes one chunk of an infinite map: tile IDs, transforms, tileset
+    // indices and world-space collision rects. Safe to call from any thread.
+    static void loadChunk(const LevelData &data, const ChunkRecord &record, LevelChunk &out);
+
+    // Parses jsonPath and writes its cooked file. Used by mapc.
+    static bool cook(const std::string &jsonPath, const std::string &cookedPath);
+
+    static std::string cookedPathFor(const std::string &jsonPath);
+    // Reads path from the mounted asset pack, or from disk if it is not packed.
+    static bool readFile(const std::string &path, std::vector<char> &out);
+};
+
+#endif // LEVEL_FORMAT_H
@@ -0,0 +1,61 @@
+// LevelPreloader.h
+#ifndef LEVEL_PRELOADER_H
+#define LEVEL_PRELOADER_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Level.h"
+
+// Parses upcoming maps on a background thread and prefetches their tileset
+// images, so switching levels only has to swap in an already built Level.
+//
+// Preloaded levels are held in memory until taken; maxLevels and
+// memoryBudget (parsed map data plus decoded tileset textures) bound how
+// many can be waiting at once.
+class LevelPreloader
+{
+public:
+    LevelPreloader(int maxLevels, size_t memoryBudget);
+    ~LevelPreloader();
+
+    // Starts preloading filename under index unless it is already preloaded
+    // or the limits are reached. Returns true if the level is (or will be) preloaded.
+    bool request(int index, const std::string &filename);
+
+    // Call once per tick on the main thread: hands finished parses their
+    // tileset prefetches. Never blocks.
+    void poll();
+
+    // True once the level at index is parsed and all its tilesets are resident.
+    bool isReady(int index) const;
+
+    // Returns the preloaded level for index with its textures loaded, waiting
+    // for the parse if needed. Returns nullptr if index was never requested.
+    // Must be called on the render thread.
+    std::unique_ptr<Level> take(int index, SDL_Renderer *renderer);
+
+    void clear();
+
+    // Bytes currently held by preloaded levels.
+    size_t getMemoryUsage() const;
+
+private:
+    struct Entry
+    {
+        int index;
+        std::future<std::unique_ptr<Level>> pending;
+        std::unique_ptr<Level> level;
+        std::vector<TextureHandle> tilesetTextures;
+    };
+
+    void finishParse(Entry &entry);
+    size_t entryMemory(const Entry &entry) const;
+
+    int maxLevels;
+    size_t memoryBudget;
+    std::vector<Entry> entries;
+};
+
+#endif // LEVEL_PRELOADER_H
@@ -0,0 +1,14 @@
+// MappedFile.h
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Maps path read-only and returns the view, or nullptr if the file is missing
+// or empty. The view stays valid until unmapFile(), even if the file is
+// replaced on disk in the meantime.
+const char *mapFile(const std::string &path, size_t &size);
+void unmapFile(const char *data, size_t size);
+
+#endif // MAPPED_FILE_H
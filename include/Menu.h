@@ -8,6 +8,7 @@
 #include <vector>
 #include <unordered_map>
 #include "SDLDeleters.h"
+#include "RenderStats.h"
 #include "ResourceManager.h"
 
 // Button abstraction with its own hover update.
@@ -15,10 +16,8 @@ class Button
 {
 public:
     Button(const std::string &normalPath, const std::string &hoverPath, const SDL_Rect &rect, SDL_Renderer *renderer)
-        : rect(rect), hovered(false)
+        : rect(rect), hovered(false), texture(renderer, normalPath), hoverTexture(renderer, hoverPath)
     {
-        texture = ResourceManager::loadTexture(renderer, normalPath);
-        hoverTexture = ResourceManager::loadTexture(renderer, hoverPath);
     }
 
     // Update the hover state based on current mouse position.
@@ -31,8 +30,8 @@ public:
     // Render the button using the appropriate texture.
     void render(SDL_Renderer *renderer) const
     {
-        SDL_Texture *tex = hovered && hoverTexture ? hoverTexture : texture;
-        SDL_RenderCopy(renderer, tex, nullptr, &rect);
+        SDL_Texture *tex = hovered && hoverTexture ? hoverTexture.get() : texture.get();
+        RenderStats::copy(renderer, tex, nullptr, &rect);
     }
 
     bool getHovered() const { return hovered; }
@@ -40,8 +39,8 @@ public:
 private:
     SDL_Rect rect;             // Now declared first.
     bool hovered;              // Declared after rect.
-    SDL_Texture *texture;      // Not owned; managed by ResourceManager.
-    SDL_Texture *hoverTexture; // Not owned; managed by ResourceManager.
+    TextureRef texture;      // Shared via ResourceManager.
+    TextureRef hoverTexture; // Shared via ResourceManager.
 };
 
 class Menu
@@ -55,7 +54,7 @@ public:
 
 private:
     SDL_Renderer *renderer;  // Not owned.
-    SDL_Texture *background; // Loaded via ResourceManager.
+    TextureRef background;   // Shared via ResourceManager.
     std::vector<Button> buttons;
     bool isPause;
 
@@ -0,0 +1,72 @@
+// PixelCache.h
+#ifndef PIXEL_CACHE_H
+#define PIXEL_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// On-disk cache of decoded images, so warm starts skip PNG/JPG decoding.
+//
+// Each image is stored once decoded as RGBA32 pixels with straight alpha, which
+// is what SDL's blend modes expect. Entries are keyed by the image path and
+// validated against a stamp of the source: the content hash when the image
+// comes from the asset pack, size and mtime for a loose file. A stale or
+// missing entry just means one more decode.
+//
+// Cache hits are memory-mapped and wrapped in a surface without copying, so
+// the pixels go from the page cache straight into SDL_UpdateTexture.
+// Surfaces returned by load() must be freed with freeSurface().
+class PixelCache
+{
+public:
+    static const std::uint32_t VERSION = 1;
+
+    // Directory entries are stored in; created on first write. An empty
+    // directory (the default) turns the cache off. Set it before any load.
+    static void setDirectory(const std::string &dir);
+
+    // Loads path as an RGBA32 surface, from the cache if possible, otherwise
+    // decoding it and writing a cache entry. Safe to call from any thread.
+    // Returns nullptr if the image cannot be decoded.
+    static SDL_Surface *load(const std::string &path);
+    static void freeSurface(SDL_Surface *surface);
+
+    // Prints hits, misses and the decode time saved per asset group
+    // (tilesets, player, enemies, menu, ...) since the last call, then resets them.
+    static void logStats();
+
+private:
+    struct CacheHeader
+    {
+        char magic[4]; // "SSPX"
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint64_t sourceStamp;
+        std::uint64_t decodeMicros; // What the decode took when the entry was written.
+    };
+
+    struct GroupStats
+    {
+        int hits = 0;
+        int misses = 0;
+        double hitMs = 0.0;    // Time spent loading cached pixels.
+        double decodeMs = 0.0; // Time spent decoding (misses).
+        double savedMs = 0.0;  // Recorded decode time of every hit, minus hitMs.
+    };
+
+    static bool sourceStamp(const std::string &path, std::uint64_t &stamp);
+    static std::string entryPath(const std::string &path);
+    static SDL_Surface *loadEntry(const std::string &file, std::uint64_t stamp, std::uint64_t &decodeMicros);
+    static void writeEntry(const std::string &file, SDL_Surface *surface, std::uint64_t stamp, std::uint64_t decodeMicros);
+    static std::string groupOf(const std::string &path);
+
+    static std::string directory;
+    static std::mutex statsMutex;
+    static std::map<std::string, GroupStats> stats;
+};
+
+#endif // PIXEL_CACHE_H
@@ -8,6 +8,7 @@
 #include "Level.h"
 #include "PlayerAnimation.h"
 #include "PlayerWeapons.h"
+#include "InputCommand.h"
 
 // The Player class now delegates collision detection to a separate CollisionHandler (see CollisionHandler.h)
 // and relies on ResourceManager (used in its components) for texture management.
@@ -17,10 +18,12 @@ public:
     Player(SDL_Renderer *renderer, Level *level);
     ~Player();
 
-    void updateInput(const Uint8 *keys);
-    void shoot(int mouseX, int mouseY, int cameraX, int cameraY);
+    void updateInput(const InputCommand &command);
+    // Fires the held weapon (or punches) toward a world point.
+    void shoot(float targetX, float targetY, EventBus &events);
     void update(int screenWidth, int screenHeight);
-    void render(SDL_Renderer *renderer, int cameraX, int cameraY);
+    // alpha: how far between the previous and the current tick to draw (0..1).
+    void render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha = 1.0f);
 
     float getX() const { return posX; }
     float getY() const { return posY; }
@@ -28,6 +31,13 @@ public:
     float getHeight() const { return spriteHeight; }
     float getAngle() const { return angle; }
     void setAngle(float newAngle) { angle = newAngle; }
+    // Draw at the current position on the next frame instead of blending
+    // from the previous tick (after a load or teleport).
+    void resetInterpolation()
+    {
+        prevX = posX;
+        prevY = posY;
+    }
 
     // Exposed movement variables.
     float velX, velY;
@@ -37,8 +47,12 @@ public:
 
     int getHealth() const { return health; }
     bool isDead() const { return dead; }
+    // Ignores all damage while set; stress runs keep the player alive this way.
+    void setInvulnerable(bool value) { invulnerable = value; }
     void takeDamage(int dmg)
     {
+        if (invulnerable)
+            return;
         health -= dmg;
         if (health <= 0)
         {
@@ -47,20 +61,24 @@ public:
         }
     }
 
-    PlayerWeapons *getWeapons() { return weapons.get(); }
-    PlayerAnimation *getAnimation() { return animation.get(); }
+    PlayerWeapons *getWeapons() { return &weapons; }
+    PlayerAnimation *getAnimation() { return &animation; }
 
 private:
+    friend class SaveGame;
+
     SDL_Renderer *renderer; // Not owned.
     Level *level;           // Not owned.
 
-    std::unique_ptr<PlayerAnimation> animation;
-    std::unique_ptr<PlayerWeapons> weapons;
+    // Held by value so a Player can be copied (see Game's level snapshot).
+    PlayerAnimation animation;
+    PlayerWeapons weapons;
 
     float posX, posY;
+    float prevX, prevY; // Position before the last tick, for interpolation.
     float angle = 0.0f;
-    const float speed = 3.0f;
-    const int spriteWidth = 54, spriteHeight = 54;
+    static constexpr float speed = 3.0f;
+    static constexpr int spriteWidth = 54, spriteHeight = 54;
 
     SDL_Rect collisionBox;
     std::vector<Bullet> bullets;
@@ -68,6 +86,7 @@ private:
 
     int health;
     bool dead;
+    bool invulnerable = false;
 
     // Removed direct collision detection; see CollisionHandler.
 };
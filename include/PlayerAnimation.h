@@ -2,8 +2,7 @@
 #define PLAYER_ANIMATION_H
 
 #include <SDL2/SDL.h>
-#include <memory>
-#include "SDLDeleters.h"
+#include "ResourceManager.h"
 
 enum class AnimationState
 {
@@ -39,6 +38,9 @@ public:
     // Expose current attack state.
     bool isAttacking() const { return currentState == AnimationState::ATTACKING; }
 
+    // Advances the death animation and effect; called every tick while dead.
+    void updateDead();
+
     void renderDead(SDL_Renderer *renderer, float x, float y, float angle);
     void triggerDeath()
     {
@@ -51,43 +53,43 @@ public:
     void renderDeathEffect(SDL_Renderer *renderer, float x, float y, float angle);
 
 private:
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> idleTexture;
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> runTexture;
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> attackTexture;
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> attachedIdleTexture;
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> attachedRunTexture;
+    friend class SaveGame;
+
+    TextureRef idleTexture;
+    TextureRef runTexture;
+    TextureRef attackTexture;
+    TextureRef attachedIdleTexture;
+    TextureRef attachedRunTexture;
 
     int frame;
     int frameTime;
 
-    const int FRAME_SPEED = 3;
-    const int IDLE_FRAMES = 1;
-    const int RUN_FRAMES = 8;
-    const int ATTACK_FRAMES = 8;
+    static constexpr int FRAME_SPEED = 3;
+    static constexpr int IDLE_FRAMES = 1;
+    static constexpr int RUN_FRAMES = 8;
+    static constexpr int ATTACK_FRAMES = 8;
 
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> legsTexture;
+    TextureRef legsTexture;
     int legsFrame;
     int legsFrameTime;
-    const int LEGS_FRAMES = 10;
-    const int LEGS_FRAME_SPEED = 5;
+    static constexpr int LEGS_FRAMES = 10;
+    static constexpr int LEGS_FRAME_SPEED = 5;
 
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> deadEffectTexture;
+    TextureRef deadEffectTexture;
     int deadEffectFrame;
     int deadEffectFrameTime;
-    const int DEAD_EFFECT_FRAMES = 4;
-    const int DEAD_EFFECT_SPEED = 50;
+    static constexpr int DEAD_EFFECT_FRAMES = 4;
+    static constexpr int DEAD_EFFECT_SPEED = 50;
     int deadEffectDelayCounter = 0;
-    const int deadEffectDelayThreshold = 30;
+    static constexpr int deadEffectDelayThreshold = 30;
 
     AnimationState currentState;
 
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> loadTexture(SDL_Renderer *renderer, const char *path);
-
-    std::unique_ptr<SDL_Texture, SDLTextureDeleter> deadTexture;
+    TextureRef deadTexture;
     int deathFrame;
     int deathFrameTime;
-    const int DEATH_FRAMES = 7;
-    const int DEATH_FRAME_SPEED = 3;
+    static constexpr int DEATH_FRAMES = 7;
+    static constexpr int DEATH_FRAME_SPEED = 3;
 
     bool rightHand; // true = right punch, false = left punch
 };
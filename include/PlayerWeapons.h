@@ -1,10 +1,10 @@
 #ifndef PLAYER_WEAPONS_H
 #define PLAYER_WEAPONS_H
 
-#include "Weapon.h" // Now defines AbstractWeapon, ProjectileWeapon, MeleeWeapon
+#include "Weapon.h" // Defines Weapon, ProjectileWeapon, MeleeWeapon
 #include "Bullet.h"
 #include <vector>
-#include <memory>
+#include <optional>
 
 class PlayerWeapons
 {
@@ -12,17 +12,17 @@ public:
     PlayerWeapons();
     ~PlayerWeapons();
 
-    // Pickup a new weapon. The argument can be used to decide which derived class to instantiate.
-    void pickupWeapon(std::unique_ptr<AbstractWeapon> newWeapon, SDL_Renderer *renderer);
+    // Pickup a new weapon.
+    void pickupWeapon(Weapon newWeapon, SDL_Renderer *renderer);
 
     // Drop the current weapon.
-    std::unique_ptr<AbstractWeapon> dropWeapon(float playerX, float playerY);
+    std::optional<Weapon> dropWeapon(float playerX, float playerY);
 
     // Update the current weapon (e.g., update its animations or cooldowns).
     void update();
 
-    // Have the current weapon shoot.
-    void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY);
+    // Have the current weapon shoot; bullets it fires are reported to events.
+    void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY, EventBus &events);
 
     // Render the current weapon (if any) and any dropped weapons.
     void render(SDL_Renderer *renderer, float playerX, float playerY, float angle);
@@ -33,14 +33,16 @@ public:
     bool isMeleeWeapon() const { return currentWeapon && currentWeapon->isMelee(); }
     bool isAttacking() const;
 
-    std::unique_ptr<AbstractWeapon> releaseCurrentWeapon();
+    std::optional<Weapon> releaseCurrentWeapon();
 
 private:
+    friend class SaveGame;
+
     // Currently held weapon.
-    std::unique_ptr<AbstractWeapon> currentWeapon;
+    std::optional<Weapon> currentWeapon;
 
-    // Dropped weapons stored as unique pointers.
-    std::vector<std::unique_ptr<AbstractWeapon>> droppedWeapons;
+    // Dropped weapons stored by value.
+    std::vector<Weapon> droppedWeapons;
 
     float fireTimer = 0.0f;
 };
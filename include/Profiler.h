@@ -0,0 +1,74 @@
+// Profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+// Zones are recorded in debug builds and compiled out when NDEBUG is set
+// (`make RELEASE=1` and the benchmarks), unless PROFILER is defined
+// (`make PROFILER=1`).
+#if !defined(NDEBUG) || defined(PROFILER)
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+// Scoped timing zones for a timeline view of a frame. Each thread writes the
+// zones it closes into its own ring buffer, without locking, keeping the
+// last ZONES_PER_THREAD of them with nanosecond timestamps. A thread's
+// buffer is reused by a later thread once it exits. writeTrace() dumps a
+// copy of every buffer as Chrome trace_event JSON, to open in
+// chrome://tracing or Perfetto.
+//
+//     void Level::render(...)
+//     {
+//         PROFILE_SCOPE("Level::render");
+//         ...
+//     }
+//
+// Zone names must be string literals (or otherwise outlive the profiler).
+class Profiler
+{
+public:
+    static const int ZONES_PER_THREAD = 1 << 16;
+
+    // Nanoseconds since the profiler's epoch.
+    static std::uint64_t now();
+
+    // Records a finished zone on the calling thread.
+    static void record(const char *name, std::uint64_t startNs, std::uint64_t endNs);
+
+    // Label for the calling thread in the trace.
+    static void setThreadName(const char *name);
+
+    // Writes the buffered zones of all threads to path. Returns false (and
+    // writes nothing) when the profiler is compiled out.
+    static bool writeTrace(const std::string &path);
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name) : name(name), start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::record(name, start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *name;
+    std::uint64_t start;
+};
+
+#if PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,42 @@
+// Random.h
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// PCG32 (XSH-RR) with a fixed stream. The whole state is one 64-bit word, so
+// saves and replays capture it exactly; std::mt19937 would need 2.5 KB.
+class Random
+{
+public:
+    explicit Random(std::uint64_t seed = 0x853c49e6748fea9bull) { setSeed(seed); }
+
+    void setSeed(std::uint64_t seed)
+    {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    std::uint32_t next()
+    {
+        std::uint64_t old = state;
+        state = old * 6364136223846793005ull + INCREMENT;
+        std::uint32_t xorShifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        std::uint32_t rotation = static_cast<std::uint32_t>(old >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    // Uniform in [0, 1).
+    float nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+    std::uint64_t getState() const { return state; }
+    void setState(std::uint64_t newState) { state = newState; }
+
+private:
+    static constexpr std::uint64_t INCREMENT = 1442695040888963407ull;
+    std::uint64_t state;
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,69 @@
+// RenderStats.h
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Counts draw calls and the pixels they cover. Game code draws through these
+// wrappers rather than calling SDL_RenderCopy/CopyEx/FillRect directly, so
+// the render benchmark can report both; the overhead is one rect
+// intersection per call.
+//
+// Pixels are the destination rect clipped to the output, so a rotated copy
+// counts its unrotated rect, and overdraw counts every layer. Draws into a
+// render target are clipped to the window output all the same.
+class RenderStats
+{
+public:
+    struct Frame
+    {
+        std::uint64_t drawCalls = 0;
+        std::uint64_t pixels = 0;
+    };
+
+    // Resets the counters and picks up the current output size. Call at the
+    // start of every frame.
+    static void beginFrame(SDL_Renderer *renderer);
+    static const Frame &getFrame() { return frame; }
+
+    static int copy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst)
+    {
+        count(dst);
+        return SDL_RenderCopy(renderer, texture, src, dst);
+    }
+
+    static int copyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                      double angle, const SDL_Point *center, SDL_RendererFlip flip)
+    {
+        count(dst);
+        return SDL_RenderCopyEx(renderer, texture, src, dst, angle, center, flip);
+    }
+
+    static int fillRect(SDL_Renderer *renderer, const SDL_Rect *rect)
+    {
+        count(rect);
+        return SDL_RenderFillRect(renderer, rect);
+    }
+
+private:
+    static void count(const SDL_Rect *dst)
+    {
+        frame.drawCalls++;
+        if (!dst)
+        {
+            frame.pixels += static_cast<std::uint64_t>(output.w) * output.h;
+            return;
+        }
+        SDL_Rect visible;
+        if (output.w == 0)
+            frame.pixels += static_cast<std::uint64_t>(dst->w > 0 ? dst->w : 0) * (dst->h > 0 ? dst->h : 0);
+        else if (SDL_IntersectRect(dst, &output, &visible))
+            frame.pixels += static_cast<std::uint64_t>(visible.w) * visible.h;
+    }
+
+    static Frame frame;
+    static SDL_Rect output; // Empty until beginFrame(): nothing is clipped.
+};
+
+#endif // RENDER_STATS_H
@@ -8,12 +8,17 @@
 class Renderer
 {
 public:
-    Renderer(SDL_Window *window);
+    // software: use SDL's software renderer (no GPU), e.g. for headless runs.
+    Renderer(SDL_Window *window, bool software = false);
     ~Renderer();
 
     SDL_Renderer *getSDLRenderer() { return renderer.get(); }
     void clear();
     void present();
+    // Vsync is on by default; returns false if the driver cannot change it.
+    bool setVSync(bool enabled);
+    // Whether presents actually wait for vsync; drivers may ignore the request.
+    bool hasVSync() const;
     void drawTexture(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst, double angle = 0, SDL_Point *center = nullptr, SDL_RendererFlip flip = SDL_FLIP_NONE);
 
 private:
@@ -0,0 +1,80 @@
+// Replay.h
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "InputCommand.h"
+
+// A recorded session: the RNG seed and map it started from, then one
+// InputCommand per simulation tick with a checksum of the game state after
+// that tick. Replaying the commands through Game::update reproduces the
+// session; comparing checksums pins a desync to the exact tick.
+//
+// File layout: a ReplayHeader, then one variable-length record per tick:
+// pressed bits, movement, aim and checksum (16 bytes), followed by x, y and
+// timestamp for each pressed action. A payload hash catches corrupt files.
+// Values are stored in host byte order, like the other binary formats.
+class Replay
+{
+public:
+    static const std::uint32_t VERSION = 1;
+
+    // Recording.
+    void startRecording(std::uint64_t seed, int mapIndex);
+    void record(const InputCommand &command, std::uint32_t checksum);
+    bool save(const std::string &path) const;
+
+    // Playback. load() starts playing from the first tick.
+    bool load(const std::string &path);
+    // Next recorded command; false once every tick has been played.
+    bool next(InputCommand &command);
+    // Checks the state after the tick returned by next(). Returns false on a
+    // mismatch; the first mismatching tick is kept in getDesyncTick().
+    bool verify(std::uint32_t checksum);
+
+    void stop() { mode = Mode::IDLE; }
+
+    bool isRecording() const { return mode == Mode::RECORDING; }
+    bool isPlaying() const { return mode == Mode::PLAYING; }
+    std::uint64_t getSeed() const { return seed; }
+    int getMapIndex() const { return mapIndex; }
+    size_t getTickCount() const { return ticks.size(); }
+    size_t getTick() const { return cursor; } // Ticks played so far.
+    long getDesyncTick() const { return desyncTick; } // -1 while in sync.
+
+private:
+    enum class Mode
+    {
+        IDLE,
+        RECORDING,
+        PLAYING
+    };
+
+    struct ReplayHeader
+    {
+        char magic[4]; // "SSRP"
+        std::uint32_t version;
+        std::uint64_t seed;
+        std::int32_t mapIndex;
+        std::uint32_t tickCount;
+        std::uint64_t payloadSize;
+        std::uint64_t payloadHash; // hashBytes of everything after the header.
+    };
+
+    struct Tick
+    {
+        InputCommand command;
+        std::uint32_t checksum;
+    };
+
+    Mode mode = Mode::IDLE;
+    std::uint64_t seed = 0;
+    int mapIndex = 0;
+    std::vector<Tick> ticks;
+    size_t cursor = 0;
+    long desyncTick = -1;
+};
+
+#endif // REPLAY_H
@@ -3,17 +3,138 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+class AssetLoader;
+
+// Small integer handle into the ResourceManager texture table.
+// Handle 0 is reserved and always resolves to a null texture.
+using TextureHandle = std::uint32_t;
+const TextureHandle INVALID_TEXTURE_HANDLE = 0;
+
+// Single texture cache shared by every subsystem. Paths are interned once when
+// first acquired; after that, lookups are plain array indexing by handle.
+//
+// Images can be prefetched: they are decoded on AssetLoader worker threads and
+// turned into textures by uploadPendingTextures() on the render thread. A
+// prefetched handle resolves to a null texture until its upload has happened.
+//
+// Texture memory is kept under a budget. Once over it, the least recently used
+// unreferenced textures are destroyed; their handles stay valid and the next
+// acquire or prefetch loads them again. Referenced textures are never
+// evicted, so the budget is exceeded if they alone need more.
 class ResourceManager
 {
 public:
-    static SDL_Texture *loadTexture(SDL_Renderer *renderer, const std::string &path);
+    struct TextureInfo
+    {
+        std::string path;
+        size_t bytes;
+        int refCount;
+    };
+
+    // Returns the handle for path, loading the texture on first use, and adds a reference.
+    // If path is still being decoded in the background, waits for that decode.
+    static TextureHandle acquireTexture(SDL_Renderer *renderer, const std::string &path);
+    static void addReference(TextureHandle handle);
+    static void releaseTexture(TextureHandle handle);
+
+    // Starts decoding path on a worker thread without adding a reference.
+    static TextureHandle prefetchTexture(const std::string &path);
+    static void prefetchTextures(const std::vector<std::string> &paths);
+
+    // Creates textures for up to maxCount finished background decodes.
+    // Must be called from the render thread; returns the number uploaded.
+    static int uploadPendingTextures(SDL_Renderer *renderer, int maxCount);
+
+    // True once the texture behind handle can be drawn.
+    static bool isTextureReady(TextureHandle handle) { return handle < textures.size() && textures[handle].state == TextureState::RESIDENT; }
+    // True while any prefetched texture is still decoding or waiting for upload.
+    static bool hasPendingTextures() { return pendingCount > 0; }
+
+    // Lookups by handle; an invalid or stale handle gives nullptr, "" or 0.
+    static SDL_Texture *getTexture(TextureHandle handle) { return handle < textures.size() ? textures[handle].texture : nullptr; }
+    static const std::string &getPath(TextureHandle handle);
+
+    // Texture memory (w * h * bytes per pixel); 0 while the texture is not resident.
+    static size_t getTextureBytes(TextureHandle handle) { return handle < textures.size() ? textures[handle].bytes : 0; }
+
+    // Evicts unreferenced textures straight away if already over the new budget.
+    static void setTextureBudget(size_t bytes);
+    static size_t getTextureBudget() { return textureBudget; }
+    static size_t getResidentTextureBytes() { return residentBytes; }
+    static int getEvictionCount() { return evictionCount; }
+
+    // Every resident texture, largest first.
+    static std::vector<TextureInfo> getResidentTextures();
+
+    // Destroys every texture. Outstanding handles must not be used afterwards.
     static void clear();
 
 private:
-    static std::unordered_map<std::string, SDL_Texture *> textureCache;
+    enum class TextureState
+    {
+        DECODING, // Queued on the AssetLoader.
+        RESIDENT,
+        EVICTED, // Destroyed to stay under budget; reloaded on demand.
+        FAILED
+    };
+
+    struct TextureEntry
+    {
+        std::string path;
+        SDL_Texture *texture;
+        int refCount;
+        TextureState state;
+        size_t bytes;
+        std::uint64_t lastUsed; // useClock value at the last acquire or release.
+    };
+
+    static TextureHandle intern(const std::string &path, TextureState state);
+    static bool createTexture(SDL_Renderer *renderer, TextureEntry &entry, SDL_Surface *surface);
+    static AssetLoader &getLoader();
+    static void touch(TextureEntry &entry) { entry.lastUsed = ++useClock; }
+    static void evictToBudget();
+
+    static std::vector<TextureEntry> textures;
+    static std::unordered_map<std::string, TextureHandle> handlesByPath;
+    static std::unique_ptr<AssetLoader> loader;
+    static int pendingCount;
+    static size_t textureBudget;
+    static size_t residentBytes;
+    static int evictionCount;
+    static std::uint64_t useClock;
+};
+
+// Counted reference to a cached texture. Copies add a reference and
+// destruction releases it, so holders never manage the count by hand.
+class TextureRef
+{
+public:
+    TextureRef() = default;
+    TextureRef(SDL_Renderer *renderer, const std::string &path)
+        : handle(ResourceManager::acquireTexture(renderer, path)) {}
+    TextureRef(const TextureRef &other) : handle(other.handle) { ResourceManager::addReference(handle); }
+    TextureRef(TextureRef &&other) noexcept : handle(other.handle) { other.handle = INVALID_TEXTURE_HANDLE; }
+    ~TextureRef() { ResourceManager::releaseTexture(handle); }
+
+    TextureRef &operator=(TextureRef other) noexcept
+    {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+
+    SDL_Texture *get() const { return ResourceManager::getTexture(handle); }
+    TextureHandle getHandle() const { return handle; }
+    explicit operator bool() const { return get() != nullptr; }
+
+private:
+    TextureHandle handle = INVALID_TEXTURE_HANDLE;
 };
 
 #endif // RESOURCE_MANAGER_H
@@ -0,0 +1,145 @@
+// SaveGame.h
+#ifndef SAVE_GAME_H
+#define SAVE_GAME_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Game;
+class Weapon;
+class Bullet;
+
+// Binary snapshot of the whole simulation: level index, player, enemies and
+// their AI state, weapons (held and dropped), bullets, stats and RNG state.
+//
+// Layout: a SaveHeader with a section table, then one array of fixed-size,
+// trivially copyable records per section, 8-byte aligned. Loading is one
+// bulk read; the section offsets become typed pointers into that buffer and
+// records refer to each other by index, so nothing is parsed. A content hash
+// catches truncated or corrupt files before any game state is touched.
+//
+// Values are stored in host byte order (little-endian on every target).
+// Writes go to a temporary file that is renamed into place, so a crash
+// mid-save never leaves a broken file; the same format can back checkpoints.
+class SaveGame
+{
+public:
+    static const std::uint32_t VERSION = 2; // 2: bullet speeds in pixels per second.
+
+    static void write(const Game &game, std::vector<char> &out);
+    // Validates bytes completely, then applies them to game. Loads another
+    // map first if the save was made on a different level.
+    static bool read(const std::vector<char> &bytes, Game &game);
+
+    static bool save(const Game &game, const std::string &path);
+    static bool load(Game &game, const std::string &path);
+
+private:
+    enum Section
+    {
+        GAME,
+        PLAYER,
+        ENEMIES,
+        WEAPONS,
+        BULLETS,
+        SECTION_COUNT
+    };
+
+    struct SectionEntry
+    {
+        std::uint32_t offset; // From the start of the file.
+        std::uint32_t count;
+    };
+
+    struct SaveHeader
+    {
+        char magic[4]; // "SSSV"
+        std::uint32_t version;
+        std::uint64_t payloadHash; // hashBytes of everything after the header.
+        std::uint32_t payloadSize;
+        std::uint32_t reserved;
+        SectionEntry sections[SECTION_COUNT];
+    };
+
+    // Records refer to weapons and bullets by index into their sections;
+    // NO_WEAPON marks an empty hand.
+    static const std::int32_t NO_WEAPON = -1;
+
+    struct GameRecord
+    {
+        std::uint64_t rngState;
+        std::int32_t mapIndex;
+        std::int32_t aliveEnemies;
+        std::int32_t kills;
+        std::int32_t shotsFired;
+        std::int32_t weaponsDropped;
+        std::int32_t cameraX, cameraY;
+        std::uint32_t firstDroppedWeapon, droppedWeaponCount;
+        std::uint32_t firstEnemyBullet, enemyBulletCount;
+        std::uint32_t reserved;
+    };
+
+    struct WeaponRecord
+    {
+        std::uint8_t melee;
+        std::uint8_t type;
+        std::uint8_t active; // Firing (projectile) or attacking (melee).
+        std::uint8_t reserved;
+        std::int32_t ammo;
+        float fireRate;
+        float bulletSpeed;
+        std::int32_t damage;
+        float x, y;
+        std::int32_t frame, frameTime;
+    };
+
+    struct BulletRecord
+    {
+        float x, y;
+        float dx, dy;
+        float speed;
+        std::uint32_t active;
+    };
+
+    struct PlayerRecord
+    {
+        float posX, posY, angle;
+        float velX, velY;
+        std::int32_t collisionBox[4];
+        std::int32_t health;
+        std::uint8_t dead, moving, bareFistAttacking, rightHand;
+        std::int32_t currentWeapon;
+        float weaponFireTimer;
+        std::uint32_t firstDroppedWeapon, droppedWeaponCount;
+        std::uint32_t firstBullet, bulletCount;
+        std::int32_t animationState, frame, frameTime;
+        std::int32_t legsFrame, legsFrameTime;
+        std::int32_t deadEffectFrame, deadEffectFrameTime, deadEffectDelayCounter;
+        std::int32_t deathFrame, deathFrameTime;
+    };
+
+    struct EnemyRecord
+    {
+        float x, y, speed, angle, fireTimer;
+        std::int32_t collisionBox[4];
+        std::int32_t health, state;
+        std::int32_t runFrame, runFrameTime;
+        std::int32_t deathFrame, deathFrameTime;
+        std::int32_t deadEffectFrame, deadEffectFrameTime, deadEffectDelayCounter;
+        std::int32_t weapon;
+        std::uint8_t boss, deathAnimationPlayed, reserved[2];
+    };
+
+    static WeaponRecord recordWeapon(const Weapon &weapon);
+    static Weapon restoreWeapon(const WeaponRecord &record, SDL_Renderer *renderer);
+    static BulletRecord recordBullet(const Bullet &bullet);
+    static Bullet restoreBullet(const BulletRecord &record);
+
+    // Typed view of a section, or nullptr if it does not lie inside bytes.
+    template <typename Record>
+    static const Record *fixUp(const std::vector<char> &bytes, const SectionEntry &entry);
+};
+
+#endif // SAVE_GAME_H
@@ -0,0 +1,45 @@
+// Sprites.h
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <string>
+#include <vector>
+
+enum class WeaponType;
+
+// Paths of the gameplay sprites. The classes that draw them load them from
+// here, and Game prefetches gameplaySprites() while the menu is shown, so
+// the two cannot drift apart.
+class Sprites
+{
+public:
+    static constexpr const char *PLAYER_IDLE = "assets/player/player_idle.png";
+    static constexpr const char *PLAYER_RUN = "assets/player/player_run.png";
+    static constexpr const char *PLAYER_PUNCH = "assets/player/player_punch.png";
+    static constexpr const char *PLAYER_IDLE_ATTACHED = "assets/player/player_idle_attached.png";
+    static constexpr const char *PLAYER_RUN_ATTACHED = "assets/player/player_run_attached.png";
+    static constexpr const char *PLAYER_DEAD = "assets/player/player_dead.png";
+    static constexpr const char *PLAYER_LEGS = "assets/player/player_legs.png";
+
+    static constexpr const char *DEATH_EFFECT = "assets/effect.png";
+
+    static constexpr const char *ENEMY_IDLE = "assets/enemies/enemy_idle.png";
+    static constexpr const char *ENEMY_RUN = "assets/enemies/enemy_run.png";
+    static constexpr const char *ENEMY_DEAD = "assets/enemies/enemy_dead.png";
+    static constexpr const char *BOSS_IDLE = "assets/enemies/boss_idle.png";
+    static constexpr const char *BOSS_RUN = "assets/enemies/boss_run.png";
+    static constexpr const char *BOSS_DEAD = "assets/enemies/boss_dead.png";
+
+    static constexpr const char *WEAPON_FIRE = "assets/weapons/fire.png";
+
+    // Per-weapon sprites; attack sprites exist for melee weapons only.
+    static std::string weaponHeld(WeaponType type);
+    static std::string weaponDropped(WeaponType type);
+    static std::string weaponAttack(WeaponType type);
+
+    // Every sprite needed once gameplay starts: the player, enemies, bosses
+    // and the weapons enemies spawn with or drop.
+    static std::vector<std::string> gameplaySprites();
+};
+
+#endif // SPRITES_H
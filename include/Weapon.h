@@ -3,8 +3,13 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
-#include <memory>
+#include <utility>
+#include <variant>
 #include "Bullet.h"
+#include "ResourceManager.h"
+
+struct EventBus;
+enum class EventTarget;
 
 // Enumeration for weapon types.
 enum class WeaponType
@@ -20,57 +25,32 @@ enum class WeaponType
     UZI
 };
 
-// Abstract base class for weapons.
-class AbstractWeapon
+// Projectile weapon implementation.
+class ProjectileWeapon
 {
 public:
-    virtual ~AbstractWeapon() = default;
+    ProjectileWeapon(WeaponType type, int ammo, float fireRate, float bulletSpeed, int damage);
 
-    // Shoot: spawns bullets or triggers a melee attack.
-    virtual void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY) = 0;
+    // Shoot: spawns a bullet toward the aim point and reports it to events
+    // (when not null) as a shot by shooter.
+    void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY,
+               EventBus *events, EventTarget shooter);
 
-    // Update weapon state (cooldowns, animations, etc.)
-    virtual void update() = 0;
+    // Update weapon state (firing animation).
+    void update();
 
-    // Render any weapon-specific effects (e.g. fire/attack animations).
-    virtual void render(SDL_Renderer *renderer, float posX, float posY, float angle, bool dropped) = 0;
+    // Render the weapon held by its owner, or on the ground when dropped.
+    void render(SDL_Renderer *renderer, float playerX, float playerY, float angle, bool dropped);
 
     // Initialize textures/resources.
-    virtual void initialize(SDL_Renderer *renderer) = 0;
-
-    // Check for ammo (for projectile weapons).
-    virtual bool hasAmmo() const = 0;
-
-    // Returns true if this is a melee weapon.
-    virtual bool isMelee() const = 0;
-
-    // Get the weapon type.
-    virtual WeaponType getType() const = 0;
-
-    virtual float getX() const = 0;
-    virtual float getY() const = 0;
-    virtual void setPosition(float newX, float newY) = 0;
-
-    virtual float getFireRate() const = 0;
-};
+    void initialize(SDL_Renderer *renderer);
 
-// Projectile weapon implementation.
-class ProjectileWeapon : public AbstractWeapon
-{
-public:
-    ProjectileWeapon(WeaponType type, int ammo, float fireRate, float bulletSpeed, int damage);
-    virtual ~ProjectileWeapon() = default;
+    bool hasAmmo() const;
+    bool isMelee() const { return false; }
+    bool isAttacking() const { return false; }
+    WeaponType getType() const { return type; }
 
-    virtual void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY) override;
-    virtual void update() override;
-    virtual void render(SDL_Renderer *renderer, float playerX, float playerY, float angle, bool dropped) override;
-    virtual void initialize(SDL_Renderer *renderer) override;
-
-    virtual bool hasAmmo() const override;
-    virtual bool isMelee() const override { return false; }
-    virtual WeaponType getType() const override { return type; }
-
-    virtual float getFireRate() const override { return fireRate; }
+    float getFireRate() const { return fireRate; }
 
     int getDamage() const { return damage; }
 
@@ -83,6 +63,8 @@ public:
     }
 
 private:
+    friend class SaveGame;
+
     WeaponType type;
     int ammo;       // -1 for unlimited.
     float fireRate; // Time between shots.
@@ -95,46 +77,54 @@ private:
     bool isFiring;
     int fireFrame;
     int fireFrameTime;
-    const int FIRE_FRAMES = 4;
-    const int FIRE_FRAME_SPEED = 3;
+    static constexpr int FIRE_FRAMES = 4;
+    static constexpr int FIRE_FRAME_SPEED = 3;
 
-    // Texture pointers (managed via ResourceManager).
-    SDL_Texture *heldTexture;
-    SDL_Texture *droppedTexture;
-    SDL_Texture *fireTexture;
+    // Texture references (managed via ResourceManager).
+    TextureRef heldTexture;
+    TextureRef droppedTexture;
+    TextureRef fireTexture;
 };
 
 // Melee weapon implementation.
-class MeleeWeapon : public AbstractWeapon
+class MeleeWeapon
 {
 public:
     MeleeWeapon(WeaponType type, float fireRate, int damage);
-    virtual ~MeleeWeapon() = default;
 
-    virtual void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY) override;
-    virtual void update() override;
-    virtual void render(SDL_Renderer *renderer, float playerX, float playerY, float angle, bool dropped) override;
-    virtual void initialize(SDL_Renderer *renderer) override;
+    // Shoot: triggers a melee attack. Fires no bullet, so reports no shot.
+    void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY,
+               EventBus *events, EventTarget shooter);
 
-    virtual bool hasAmmo() const override { return true; } // Unlimited for melee.
-    virtual bool isMelee() const override { return true; }
-    virtual WeaponType getType() const override { return type; }
+    // Update weapon state (attack animation).
+    void update();
 
-    virtual float getFireRate() const override { return fireRate; }
+    // Render the weapon held by its owner, or on the ground when dropped.
+    void render(SDL_Renderer *renderer, float playerX, float playerY, float angle, bool dropped);
+
+    // Initialize textures/resources.
+    void initialize(SDL_Renderer *renderer);
+
+    bool hasAmmo() const { return true; } // Unlimited for melee.
+    bool isMelee() const { return true; }
+    bool isAttacking() const { return attacking; }
+    WeaponType getType() const { return type; }
+
+    float getFireRate() const { return fireRate; }
 
     int getDamage() const { return damage; }
 
-    virtual float getX() const override { return x; }
-    virtual float getY() const override { return y; }
-    virtual void setPosition(float newX, float newY) override
+    float getX() const { return x; }
+    float getY() const { return y; }
+    void setPosition(float newX, float newY)
     {
         x = newX;
         y = newY;
     }
 
-    bool isCurrentlyAttacking() const { return isAttacking; }
-
 private:
+    friend class SaveGame;
+
     WeaponType type;
     float fireRate;
     int damage;
@@ -142,16 +132,112 @@ private:
     float x, y; // Position when dropped
 
     // Attack animation state.
-    bool isAttacking;
+    bool attacking;
     int attackFrame;
     int attackFrameTime;
-    const int ATTACK_FRAMES = 8;
-    const int ATTACK_FRAME_SPEED = 3;
+    static constexpr int ATTACK_FRAMES = 8;
+    static constexpr int ATTACK_FRAME_SPEED = 3;
+
+    // Texture references.
+    TextureRef heldTexture;
+    TextureRef attackTexture;
+    TextureRef droppedTexture;
+};
+
+// A weapon stored by value as a tagged union of the concrete weapon types.
+// Calls are dispatched with std::visit, so per-frame update/render over many
+// weapons need no virtual calls, heap indirection or RTTI.
+class Weapon
+{
+public:
+    Weapon(ProjectileWeapon weapon) : impl(std::move(weapon)) {}
+    Weapon(MeleeWeapon weapon) : impl(std::move(weapon)) {}
+
+    void shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY,
+               EventBus *events, EventTarget shooter)
+    {
+        std::visit([&](auto &w)
+                   { w.shoot(bullets, playerX, playerY, aimX, aimY, events, shooter); },
+                   impl);
+    }
+
+    void update()
+    {
+        std::visit([](auto &w)
+                   { w.update(); },
+                   impl);
+    }
+
+    void render(SDL_Renderer *renderer, float posX, float posY, float angle, bool dropped)
+    {
+        std::visit([&](auto &w)
+                   { w.render(renderer, posX, posY, angle, dropped); },
+                   impl);
+    }
+
+    void initialize(SDL_Renderer *renderer)
+    {
+        std::visit([renderer](auto &w)
+                   { w.initialize(renderer); },
+                   impl);
+    }
+
+    bool hasAmmo() const
+    {
+        return std::visit([](const auto &w)
+                          { return w.hasAmmo(); },
+                          impl);
+    }
+
+    // Returns true if this is a melee weapon.
+    bool isMelee() const { return std::holds_alternative<MeleeWeapon>(impl); }
+
+    // True while a melee weapon plays its attack animation.
+    bool isAttacking() const
+    {
+        const MeleeWeapon *melee = std::get_if<MeleeWeapon>(&impl);
+        return melee && melee->isAttacking();
+    }
+
+    WeaponType getType() const
+    {
+        return std::visit([](const auto &w)
+                          { return w.getType(); },
+                          impl);
+    }
+
+    float getX() const
+    {
+        return std::visit([](const auto &w)
+                          { return w.getX(); },
+                          impl);
+    }
+
+    float getY() const
+    {
+        return std::visit([](const auto &w)
+                          { return w.getY(); },
+                          impl);
+    }
+
+    void setPosition(float newX, float newY)
+    {
+        std::visit([=](auto &w)
+                   { w.setPosition(newX, newY); },
+                   impl);
+    }
+
+    float getFireRate() const
+    {
+        return std::visit([](const auto &w)
+                          { return w.getFireRate(); },
+                          impl);
+    }
+
+private:
+    friend class SaveGame;
 
-    // Texture pointers.
-    SDL_Texture *heldTexture;
-    SDL_Texture *attackTexture;
-    SDL_Texture *droppedTexture;
+    std::variant<ProjectileWeapon, MeleeWeapon> impl;
 };
 
 #endif // WEAPON_H
@@ -1,40 +1,162 @@
 #define SDL_MAIN_HANDLED
 #include <Game.h>
+#include <Constants.h>
+#include <FramePacer.h>
+#include <Profiler.h>
 #include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 int main(int argc, char *argv[])
 {
+    // --fps N: pace frames to N per second with vsync off. By default
+    // (or with --fps 0) vsync paces the loop, or FramePacer at the display
+    // refresh rate if the driver does not grant vsync.
+    // --record FILE: play from the first map, recording input to FILE.
+    // --replay FILE: play FILE back and exit at its end.
+    // --headless: no window or GPU; run the replay, or --ticks N ticks of the
+    // first map, as fast as possible and log simulation timings.
+    // --stress: headless runs of --map I (default 0) with --enemies,
+    // --bosses, --bullets, --player-bullets and --weapons on the last of
+    // --steps runs and half as many on each run before; tick times per run go
+    // to --csv FILE.
+    // --trace FILE: on exit, write the profiler zones as a Chrome trace
+    // (debug builds; F10 writes one at any time).
+    int targetFps = 0;
+    bool headless = false;
+    long headlessTicks = -1;
+    bool stress = false;
+    StressPopulation stressPopulation;
+    stressPopulation.enemies = 1000;
+    stressPopulation.bosses = 10;
+    stressPopulation.bullets = 2000;
+    stressPopulation.playerBullets = 2000;
+    stressPopulation.weapons = 200;
+    int stressSteps = 6;
+    int stressMap = 0;
+    const char *stressCsv = "stress.csv";
+    const char *tracePath = nullptr;
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            targetFps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            headlessTicks = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--stress") == 0)
+            stress = headless = true;
+        else if (std::strcmp(argv[i], "--enemies") == 0 && i + 1 < argc)
+            stressPopulation.enemies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--bosses") == 0 && i + 1 < argc)
+            stressPopulation.bosses = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--bullets") == 0 && i + 1 < argc)
+            stressPopulation.bullets = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--player-bullets") == 0 && i + 1 < argc)
+            stressPopulation.playerBullets = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--weapons") == 0 && i + 1 < argc)
+            stressPopulation.weapons = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+            stressSteps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--map") == 0 && i + 1 < argc)
+            stressMap = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            stressCsv = argv[++i];
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else
+            std::cerr << "Ignoring unknown argument " << argv[i] << std::endl;
+    }
+
     Game game;
 
-    if (!game.init("slaughtership", 1200, 768))
+    if (!game.init("slaughtership", 1200, 768, headless))
     {
         return -1;
     }
 
-    const int FPS = 60;
-    const int frameDelay = 1000 / FPS; // 16.67ms per framef
+    bool started = true;
+    if (replayPath)
+        started = game.startReplay(replayPath);
+    else if (recordPath)
+        started = game.startRecording(recordPath);
+    if (!started)
+    {
+        game.clean();
+        return -1;
+    }
 
-    Uint32 frameStart;
-    int frameTime;
+    if (stress)
+    {
+        bool written = game.runStress(stressPopulation, stressSteps > 0 ? stressSteps : 1,
+                                      headlessTicks >= 0 ? headlessTicks : STRESS_DEFAULT_TICKS, stressMap, stressCsv);
+        if (tracePath)
+            Profiler::writeTrace(tracePath);
+        game.clean();
+        return written ? 0 : 1;
+    }
 
-    while (game.isRunning())
+    if (headless)
     {
-        frameStart = SDL_GetTicks(); // Get the start time of the frame
+        bool inSync = game.runHeadless(headlessTicks >= 0 ? headlessTicks : HEADLESS_DEFAULT_TICKS);
+        if (tracePath)
+            Profiler::writeTrace(tracePath);
+        game.clean();
+        return inSync ? 0 : 1;
+    }
 
-        game.handleEvents();
-        game.update();
-        game.render();
+    FramePacer pacer(targetFps);
+    if (targetFps > 0)
+        game.setVSync(false);
+    else if (!game.hasVSync())
+    {
+        // The driver ignored the vsync request, so nothing would hold the
+        // loop back; pace it to the display instead.
+        int refreshRate = game.getRefreshRate();
+        targetFps = refreshRate > 0 ? refreshRate : FALLBACK_REFRESH_RATE;
+        pacer.setTargetFps(targetFps);
+        SDL_Log("Vsync unavailable; pacing to %d fps", targetFps);
+    }
 
-        // Calculate how long the frame took
-        frameTime = SDL_GetTicks() - frameStart;
+    // The simulation runs in fixed ticks; rendering runs at the display or
+    // --fps rate and interpolates between the last two ticks.
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    Uint64 previousTime = SDL_GetPerformanceCounter();
+    double accumulator = 0.0;
 
-        // Delay to maintain 60 FPS
-        if (frameTime < frameDelay)
+    while (game.isRunning())
+    {
+        Uint64 now = SDL_GetPerformanceCounter();
+        double frameTime = (now - previousTime) / frequency;
+        previousTime = now;
+
+        // After a stall (window drag, breakpoint) drop the backlog instead of
+        // fast-forwarding through it.
+        if (frameTime > MAX_FRAME_TIME)
+            frameTime = MAX_FRAME_TIME;
+        accumulator += frameTime;
+
+        game.handleEvents();
+        while (accumulator >= FIXED_TIMESTEP)
         {
-            SDL_Delay(frameDelay - frameTime);
+            game.update();
+            accumulator -= FIXED_TIMESTEP;
         }
+        game.render(static_cast<float>(accumulator / FIXED_TIMESTEP));
+        pacer.endFrame();
     }
 
+    SDL_Log("Frame times (%s): %s", targetFps > 0 ? "paced" : "vsync",
+            pacer.getHistogram().summary().c_str());
+    if (tracePath)
+        Profiler::writeTrace(tracePath);
     game.clean();
     return 0;
 }
@@ -0,0 +1,127 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include "PixelCache.h"
+#include <algorithm>
+
+AssetLoader::AssetLoader(unsigned threadCount) : stopping(false)
+{
+    if (threadCount == 0)
+    {
+        // Leave one core for the main/render thread.
+        unsigned hardware = std::thread::hardware_concurrency();
+        threadCount = std::clamp(hardware > 1 ? hardware - 1 : 1u, 1u, 4u);
+    }
+
+    for (unsigned i = 0; i < threadCount; i++)
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    workAvailable.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+
+    // Free surfaces nobody took.
+    for (auto &entry : jobs)
+    {
+        if (entry.second.surface)
+            PixelCache::freeSurface(entry.second.surface);
+    }
+}
+
+void AssetLoader::request(const std::string &path)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.count(path))
+            return;
+        jobs[path] = {JobState::QUEUED, nullptr};
+        queue.push_back(path);
+    }
+    workAvailable.notify_one();
+}
+
+bool AssetLoader::isReady(const std::string &path) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(path);
+    return it != jobs.end() && it->second.state == JobState::DONE;
+}
+
+SDL_Surface *AssetLoader::take(const std::string &path)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = jobs.find(path);
+    if (it == jobs.end())
+        return nullptr;
+
+    if (it->second.state == JobState::QUEUED)
+    {
+        // Nobody has started on it yet: decode here rather than wait in line.
+        queue.erase(std::find(queue.begin(), queue.end(), path));
+        jobs.erase(it);
+        lock.unlock();
+        SDL_Surface *surface = PixelCache::load(path);
+        if (!surface)
+            SDL_Log("Failed to decode image: %s, SDL_Error: %s", path.c_str(), SDL_GetError());
+        return surface;
+    }
+
+    jobFinished.wait(lock, [&]
+                     { return jobs.at(path).state == JobState::DONE; });
+    it = jobs.find(path);
+    SDL_Surface *surface = it->second.surface;
+    jobs.erase(it);
+    finished.erase(std::find(finished.begin(), finished.end(), path));
+    return surface;
+}
+
+void AssetLoader::collect(std::vector<std::pair<std::string, SDL_Surface *>> &out, size_t maxCount)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    while (maxCount > 0 && !finished.empty())
+    {
+        std::string path = std::move(finished.front());
+        finished.pop_front();
+        auto it = jobs.find(path);
+        out.emplace_back(path, it->second.surface);
+        jobs.erase(it);
+        maxCount--;
+    }
+}
+
+void AssetLoader::workerLoop()
+{
+    PROFILE_THREAD("asset loader");
+    for (;;)
+    {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this]
+                               { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+            path = std::move(queue.front());
+            queue.pop_front();
+            jobs[path].state = JobState::DECODING;
+        }
+
+        SDL_Surface *surface = PixelCache::load(path);
+        if (!surface)
+            SDL_Log("Failed to decode image: %s, SDL_Error: %s", path.c_str(), SDL_GetError());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs[path] = {JobState::DONE, surface};
+            finished.push_back(path);
+        }
+        jobFinished.notify_all();
+    }
+}
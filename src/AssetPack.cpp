@@ -0,0 +1,217 @@
+#include "AssetPack.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace
+{
+    const char PACK_MAGIC[4] = {'S', 'S', 'P', 'K'};
+    const size_t DATA_ALIGNMENT = 16;
+}
+
+const char *AssetPack::mapping = nullptr;
+size_t AssetPack::mappingSize = 0;
+const AssetPack::PackEntry *AssetPack::entries = nullptr;
+std::uint32_t AssetPack::entryCount = 0;
+
+std::string AssetPack::normalizePath(const std::string &path)
+{
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+bool AssetPack::mount(const std::string &packPath)
+{
+    unmount();
+    mapping = mapFile(packPath, mappingSize);
+    if (!mapping)
+    {
+        std::cout << "No asset pack at " << packPath << ", using loose files" << std::endl;
+        return false;
+    }
+    if (!validate())
+    {
+        std::cerr << "Asset pack " << packPath << " is invalid, using loose files" << std::endl;
+        unmount();
+        return false;
+    }
+    std::cout << "Mounted asset pack " << packPath << " (" << entryCount << " files)" << std::endl;
+    return true;
+}
+
+bool AssetPack::validate()
+{
+    if (mappingSize < sizeof(PackHeader))
+        return false;
+    const PackHeader *header = reinterpret_cast<const PackHeader *>(mapping);
+    if (std::memcmp(header->magic, PACK_MAGIC, 4) != 0 || header->version != VERSION)
+        return false;
+    if (header->entryCount > (mappingSize - sizeof(PackHeader)) / sizeof(PackEntry))
+        return false;
+
+    entries = reinterpret_cast<const PackEntry *>(mapping + sizeof(PackHeader));
+    entryCount = header->entryCount;
+    for (std::uint32_t i = 0; i < entryCount; i++)
+    {
+        const PackEntry &entry = entries[i];
+        if (entry.offset > mappingSize || entry.size > mappingSize - entry.offset ||
+            entry.pathOffset > mappingSize || entry.pathLength > mappingSize - entry.pathOffset ||
+            (i > 0 && entries[i - 1].hash > entry.hash))
+            return false;
+    }
+    return true;
+}
+
+void AssetPack::unmount()
+{
+    if (mapping)
+        unmapFile(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+bool AssetPack::find(const std::string &path, const char *&data, size_t &size)
+{
+    if (!mapping)
+        return false;
+
+    std::string key = normalizePath(path);
+    std::uint64_t hash = hashBytes(key.data(), key.size());
+    const PackEntry *end = entries + entryCount;
+    const PackEntry *it = std::lower_bound(entries, end, hash, [](const PackEntry &entry, std::uint64_t value)
+                                           { return entry.hash < value; });
+
+    // Compare the stored path too, in case two paths share a hash.
+    for (; it != end && it->hash == hash; ++it)
+    {
+        if (it->pathLength == key.size() && std::memcmp(mapping + it->pathOffset, key.data(), key.size()) == 0)
+        {
+            data = mapping + it->offset;
+            size = static_cast<size_t>(it->size);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetPack::read(const std::string &path, std::vector<char> &out)
+{
+    const char *data;
+    size_t size;
+    if (find(path, data, size))
+    {
+        out.assign(data, data + size);
+        return true;
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0);
+    out.resize(static_cast<size_t>(fileSize));
+    return static_cast<bool>(file.read(out.data(), fileSize));
+}
+
+bool AssetPack::build(const std::string &packPath, const std::vector<std::string> &files)
+{
+    struct Source
+    {
+        std::string path;
+        std::vector<char> bytes;
+        PackEntry entry;
+    };
+
+    std::vector<Source> sources;
+    for (const auto &file : files)
+    {
+        Source source;
+        source.path = normalizePath(file);
+        if (!read(file, source.bytes))
+        {
+            std::cerr << "Failed to read " << file << std::endl;
+            return false;
+        }
+        source.entry.hash = hashBytes(source.path.data(), source.path.size());
+        sources.push_back(std::move(source));
+    }
+    std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b)
+              { return a.entry.hash < b.entry.hash; });
+
+    // Assign offsets: index, then path strings, then aligned file data.
+    std::uint64_t offset = sizeof(PackHeader) + sources.size() * sizeof(PackEntry);
+    for (auto &source : sources)
+    {
+        source.entry.pathOffset = static_cast<std::uint32_t>(offset);
+        source.entry.pathLength = static_cast<std::uint32_t>(source.path.size());
+        offset += source.path.size();
+    }
+    for (auto &source : sources)
+    {
+        offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        source.entry.offset = offset;
+        source.entry.size = source.bytes.size();
+        offset += source.bytes.size();
+    }
+
+    std::string tempPath = packPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "Failed to create " << tempPath << std::endl;
+            return false;
+        }
+
+        PackHeader header;
+        std::memcpy(header.magic, PACK_MAGIC, 4);
+        header.version = VERSION;
+        header.entryCount = static_cast<std::uint32_t>(sources.size());
+        header.reserved = 0;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const auto &source : sources)
+            out.write(reinterpret_cast<const char *>(&source.entry), sizeof(PackEntry));
+        for (const auto &source : sources)
+            out.write(source.path.data(), static_cast<std::streamsize>(source.path.size()));
+        for (const auto &source : sources)
+        {
+            static const char padding[DATA_ALIGNMENT] = {};
+            std::streamoff position = out.tellp();
+            out.write(padding, static_cast<std::streamsize>(source.entry.offset - position));
+            out.write(source.bytes.data(), static_cast<std::streamsize>(source.bytes.size()));
+        }
+        if (!out)
+        {
+            std::cerr << "Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+
+    // Replace the old pack in one step.
+#ifdef _WIN32
+    bool renamed = MoveFileExA(tempPath.c_str(), packPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = std::rename(tempPath.c_str(), packPath.c_str()) == 0;
+#endif
+    if (!renamed)
+    {
+        std::cerr << "Failed to replace " << packPath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
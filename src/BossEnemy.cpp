@@ -1,14 +1,17 @@
 #include "BossEnemy.h"
 #include "ResourceManager.h"
+#include "Sprites.h"
 #include <iostream>
 
 BossEnemy::BossEnemy(float x, float y, SDL_Renderer *renderer)
     : Enemy(x, y, renderer) // call base class constructor
 {
+    boss = true;
+
     // Override enemy textures with boss textures.
-    enemyIdleTexture = ResourceManager::loadTexture(renderer, "assets/enemies/boss_idle.png");
-    enemyRunTexture = ResourceManager::loadTexture(renderer, "assets/enemies/boss_run.png");
-    deadTexture = ResourceManager::loadTexture(renderer, "assets/enemies/boss_dead.png");
+    enemyIdleTexture = TextureRef(renderer, Sprites::BOSS_IDLE);
+    enemyRunTexture = TextureRef(renderer, Sprites::BOSS_RUN);
+    deadTexture = TextureRef(renderer, Sprites::BOSS_DEAD);
 
     // Optionally, adjust boss-specific parameters (e.g., health, speed) if desired.
     // For example:
@@ -1,11 +1,15 @@
 #include "Bullet.h"
+#include "Constants.h"
+#include "RenderStats.h"
 #include <SDL2/SDL.h>
 
 Bullet::Bullet(float x, float y, float dx, float dy, float speed)
-    : x(x), y(y), dx(dx), dy(dy), speed(speed), active(true) {}
+    : x(x), y(y), prevX(x), prevY(y), dx(dx), dy(dy), speed(speed), active(true), lifetime(0.0f) {}
 
 void Bullet::update(float dt, int screenWidth, int screenHeight)
 { // Use delta time (dt) for frame-rate independent movement.
+    prevX = x;
+    prevY = y;
     x += dx * speed * dt;
     y += dy * speed * dt;
 
@@ -14,9 +18,11 @@ void Bullet::update(float dt, int screenWidth, int screenHeight)
         active = false;
 }
 
-void Bullet::render(SDL_Renderer *renderer, int cameraX, int cameraY)
+void Bullet::render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha)
 {
-    SDL_Rect rect = {(int)(x - cameraX), (int)(y - cameraY), 5, 5};
+    float drawX = prevX + (x - prevX) * alpha;
+    float drawY = prevY + (y - prevY) * alpha;
+    SDL_Rect rect = {(int)(drawX - cameraX), (int)(drawY - cameraY), BULLET_SIZE, BULLET_SIZE};
     SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-    SDL_RenderFillRect(renderer, &rect);
+    RenderStats::fillRect(renderer, &rect);
 }
@@ -0,0 +1,71 @@
+#include "BulletCollision.h"
+#include "Profiler.h"
+#include "CollisionHandler.h"
+#include "Constants.h"
+#include <algorithm>
+
+namespace
+{
+    SDL_Rect bulletBox(const Bullet &bullet)
+    {
+        return {static_cast<int>(bullet.getX()), static_cast<int>(bullet.getY()), BULLET_SIZE, BULLET_SIZE};
+    }
+}
+
+void BulletCollision::move(std::vector<Bullet> &bullets, float dt)
+{
+    for (auto &bullet : bullets)
+    {
+        bullet.update(dt, SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
+}
+
+void BulletCollision::hitPlayer(std::vector<Bullet> &bullets, const SDL_Rect &playerBox, const CollisionGrid &walls, EventBus &events)
+{
+    PROFILE_SCOPE("BulletCollision::hitPlayer");
+    for (auto &bullet : bullets)
+    {
+        SDL_Rect box = bulletBox(bullet);
+
+        if (CollisionHandler::checkCollision(box, walls))
+            bullet.deactivate();
+
+        if (SDL_HasIntersection(&playerBox, &box))
+        {
+            events.damage.push({EventTarget::PLAYER, -1, 9999});
+            bullet.deactivate();
+        }
+    }
+}
+
+void BulletCollision::hitEnemies(std::vector<Bullet> &bullets, const std::vector<std::unique_ptr<Enemy>> &enemies,
+                                 const CollisionGrid &walls, EventBus &events)
+{
+    PROFILE_SCOPE("BulletCollision::hitEnemies");
+    for (auto &bullet : bullets)
+    {
+        SDL_Rect box = bulletBox(bullet);
+
+        if (CollisionHandler::checkCollision(box, walls))
+            bullet.deactivate();
+
+        for (size_t i = 0; i < enemies.size(); i++)
+        {
+            SDL_Rect enemyBox = enemies[i]->getCollisionBox();
+            if (!enemies[i]->isDead() && SDL_HasIntersection(&box, &enemyBox))
+            {
+                events.damage.push({EventTarget::ENEMY, static_cast<int>(i), 9999}); // Instantly kill enemy.
+                bullet.deactivate();
+                break;
+            }
+        }
+    }
+}
+
+void BulletCollision::removeInactive(std::vector<Bullet> &bullets)
+{
+    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
+                                 [](const Bullet &b)
+                                 { return !b.isActive(); }),
+                  bullets.end());
+}
@@ -0,0 +1,184 @@
+#include "ChunkStreamer.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace
+{
+    // Floor division, so views left of or above the origin map to negative chunks.
+    int floorDiv(int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+}
+
+ChunkStreamer::ChunkStreamer(const LevelData &data, int loadMargin, int evictMargin)
+    : data(data), chunkWidth(std::max(data.chunkSize * data.tileWidth, 1)),
+      chunkHeight(std::max(data.chunkSize * data.tileHeight, 1)),
+      loadMargin(loadMargin), evictMargin(std::max(evictMargin, loadMargin))
+{
+    worker = std::thread(&ChunkStreamer::workerLoop, this);
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    workAvailable.notify_all();
+    worker.join();
+
+    for (auto &entry : resident)
+        destroyChunk(*entry.second);
+}
+
+void ChunkStreamer::destroyChunk(ResidentChunk &chunk)
+{
+    if (chunk.baked)
+        SDL_DestroyTexture(chunk.baked);
+    chunk.baked = nullptr;
+}
+
+bool ChunkStreamer::update(const SDL_Rect &view)
+{
+    int left = floorDiv(view.x, chunkWidth);
+    int top = floorDiv(view.y, chunkHeight);
+    int right = floorDiv(view.x + view.w - 1, chunkWidth);
+    int bottom = floorDiv(view.y + view.h - 1, chunkHeight);
+    bool changed = false;
+
+    // Evict everything well outside the view; drop queued work for it too.
+    auto outside = [&](const ChunkKey &key)
+    {
+        return key.second < left - evictMargin || key.second > right + evictMargin ||
+               key.first < top - evictMargin || key.first > bottom + evictMargin;
+    };
+    for (auto it = resident.begin(); it != resident.end();)
+    {
+        if (outside(it->first))
+        {
+            destroyChunk(*it->second);
+            it = resident.erase(it);
+            changed = true;
+        }
+        else
+            ++it;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = requested.begin(); it != requested.end();)
+        {
+            auto queued = std::find(queue.begin(), queue.end(), it->second);
+            if (outside(it->first) && queued != queue.end())
+            {
+                queue.erase(queued);
+                it = requested.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        // Request chunks in and around the view that are not loaded or queued yet.
+        for (int y = top - loadMargin; y <= bottom + loadMargin; y++)
+        {
+            for (int x = left - loadMargin; x <= right + loadMargin; x++)
+            {
+                ChunkKey key = {y, x};
+                if (resident.count(key) || requested.count(key))
+                    continue;
+                const ChunkRecord *record = data.findChunk(x, y);
+                if (!record)
+                    continue; // Empty space in the map.
+                requested[key] = record;
+                queue.push_back(record);
+            }
+        }
+    }
+    workAvailable.notify_all();
+
+    if (!primed)
+    {
+        // Block until the first batch is in.
+        std::unique_lock<std::mutex> lock(mutex);
+        chunkFinished.wait(lock, [this]
+                           { return finished.size() >= requested.size(); });
+        primed = true;
+    }
+
+    return adoptFinished() || changed;
+}
+
+bool ChunkStreamer::adoptFinished()
+{
+    std::vector<LevelChunk> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(finished);
+    }
+
+    for (auto &chunk : done)
+    {
+        // Results for chunks evicted while decoding have no request left.
+        ChunkKey key = {chunk.y, chunk.x};
+        if (!requested.erase(key))
+            continue;
+        auto entry = std::make_unique<ResidentChunk>();
+        entry->chunk = std::move(chunk);
+        resident[key] = std::move(entry);
+    }
+    return !done.empty();
+}
+
+size_t ChunkStreamer::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto &entry : resident)
+    {
+        const ResidentChunk &chunk = *entry.second;
+        for (const auto &layer : chunk.chunk.layers)
+        {
+            bytes += layer.tiles.capacity() * sizeof(std::uint32_t) +
+                     layer.transforms.capacity() * sizeof(std::uint8_t) +
+                     layer.tilesetIndex.capacity() * sizeof(std::uint16_t);
+        }
+        bytes += chunk.chunk.collisionRects.capacity() * sizeof(SDL_Rect);
+        if (chunk.baked)
+        {
+            int w = 0, h = 0;
+            SDL_QueryTexture(chunk.baked, nullptr, nullptr, &w, &h);
+            bytes += static_cast<size_t>(w) * h * 4;
+        }
+    }
+    return bytes;
+}
+
+void ChunkStreamer::workerLoop()
+{
+    PROFILE_THREAD("chunk streamer");
+    for (;;)
+    {
+        const ChunkRecord *record;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this]
+                               { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+            record = queue.front();
+            queue.pop_front();
+        }
+
+        LevelChunk chunk;
+        {
+            PROFILE_SCOPE("ChunkStreamer::loadChunk");
+            LevelFormat::loadChunk(data, *record, chunk);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(std::move(chunk));
+        }
+        chunkFinished.notify_all();
+    }
+}
@@ -0,0 +1,89 @@
+#include "CollisionGrid.h"
+#include <algorithm>
+
+namespace
+{
+    // Floor division, so negative coordinates map to the correct cell.
+    int floorDiv(int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+}
+
+void CollisionGrid::build(std::vector<SDL_Rect> newRects, int newCellSize)
+{
+    rects = std::move(newRects);
+    cellSize = newCellSize;
+    cellStart.clear();
+    cellItems.clear();
+    columns = rows = 0;
+    if (rects.empty())
+        return;
+
+    int minX = rects[0].x, minY = rects[0].y;
+    int maxX = rects[0].x + rects[0].w, maxY = rects[0].y + rects[0].h;
+    for (const SDL_Rect &r : rects)
+    {
+        minX = std::min(minX, r.x);
+        minY = std::min(minY, r.y);
+        maxX = std::max(maxX, r.x + r.w);
+        maxY = std::max(maxY, r.y + r.h);
+    }
+    originX = floorDiv(minX, cellSize) * cellSize;
+    originY = floorDiv(minY, cellSize) * cellSize;
+    columns = floorDiv(maxX - originX, cellSize) + 1;
+    rows = floorDiv(maxY - originY, cellSize) + 1;
+
+    // Two passes: count entries per cell, then fill.
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    auto forEachCell = [&](const SDL_Rect &r, auto &&visit)
+    {
+        int x0 = (r.x - originX) / cellSize, x1 = (r.x + r.w - originX) / cellSize;
+        int y0 = (r.y - originY) / cellSize, y1 = (r.y + r.h - originY) / cellSize;
+        for (int cy = y0; cy <= y1; cy++)
+            for (int cx = x0; cx <= x1; cx++)
+                visit(static_cast<size_t>(cy) * columns + cx);
+    };
+    for (const SDL_Rect &r : rects)
+        forEachCell(r, [&](size_t cell)
+                    { cellStart[cell + 1]++; });
+    for (size_t i = 1; i < cellStart.size(); i++)
+        cellStart[i] += cellStart[i - 1];
+
+    cellItems.resize(cellStart.back());
+    std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (std::uint32_t i = 0; i < rects.size(); i++)
+        forEachCell(rects[i], [&](size_t cell)
+                    { cellItems[fill[cell]++] = i; });
+}
+
+bool CollisionGrid::intersects(const SDL_Rect &box) const
+{
+    if (columns == 0)
+        return false;
+
+    int x0 = std::max(floorDiv(box.x - originX, cellSize), 0);
+    int y0 = std::max(floorDiv(box.y - originY, cellSize), 0);
+    int x1 = std::min(floorDiv(box.x + box.w - originX, cellSize), columns - 1);
+    int y1 = std::min(floorDiv(box.y + box.h - originY, cellSize), rows - 1);
+
+    for (int cy = y0; cy <= y1; cy++)
+    {
+        for (int cx = x0; cx <= x1; cx++)
+        {
+            size_t cell = static_cast<size_t>(cy) * columns + cx;
+            for (std::uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+            {
+                if (overlaps(box, rects[cellItems[i]]))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t CollisionGrid::getMemoryFootprint() const
+{
+    return rects.capacity() * sizeof(SDL_Rect) +
+           (cellStart.capacity() + cellItems.capacity()) * sizeof(std::uint32_t);
+}
@@ -1,20 +1,23 @@
 #include "Enemy.h"
+#include "EventBus.h"
 #include "ResourceManager.h"
+#include "RenderStats.h"
+#include "Sprites.h"
 #include <cmath>
-#include <iostream>
 #include <SDL2/SDL.h>
 
 // Constructor: load enemy textures and initialize state.
 Enemy::Enemy(float x, float y, SDL_Renderer *renderer)
-    : x(x), y(y), speed(50.0f), health(100), state(EnemyState::PATROLLING), angle(0),
+    : x(x), y(y), prevX(x), prevY(y), speed(50.0f), health(100), state(EnemyState::PATROLLING), angle(0),
       deathFrame(0), deathFrameTime(0), deathAnimationPlayed(false), deadEffectFrame(0), deadEffectFrameTime(0), deadEffectDelayCounter(0), fireTimer(0.0f)
 {
     // Load textures using ResourceManager.
-    enemyIdleTexture = ResourceManager::loadTexture(renderer, "assets/enemies/enemy_idle.png");
-    enemyRunTexture = ResourceManager::loadTexture(renderer, "assets/enemies/enemy_run.png");
-    deadTexture = ResourceManager::loadTexture(renderer, "assets/enemies/enemy_dead.png");
+    enemyIdleTexture = TextureRef(renderer, Sprites::ENEMY_IDLE);
+    enemyRunTexture = TextureRef(renderer, Sprites::ENEMY_RUN);
+    deadTexture = TextureRef(renderer, Sprites::ENEMY_DEAD);
+    effectTexture = TextureRef(renderer, Sprites::DEATH_EFFECT);
 
-    weapon = std::make_unique<ProjectileWeapon>(WeaponType::SHOTGUN, WEAPON_AMMO_SHOTGUN, WEAPON_FIRE_RATE_SHOTGUN, WEAPON_BULLET_SPEED_SHOTGUN, 10);
+    weapon.emplace(ProjectileWeapon(WeaponType::SHOTGUN, WEAPON_AMMO_SHOTGUN, WEAPON_FIRE_RATE_SHOTGUN, WEAPON_BULLET_SPEED_SHOTGUN, 10));
     weapon->initialize(renderer);
 
     collisionBox.x = static_cast<int>(x) + PLAYER_COLLISION_OFFSET_X;
@@ -23,8 +26,12 @@ Enemy::Enemy(float x, float y, SDL_Renderer *renderer)
     collisionBox.h = PLAYER_COLLISION_HEIGHT;
 }
 
-void Enemy::update(float dt, const SDL_Rect &playerRect, const std::vector<SDL_Rect> &walls, std::vector<Bullet> &enemyBullets, bool playerAlive)
+void Enemy::update(float dt, const SDL_Rect &playerRect, const CollisionGrid &walls, std::vector<Bullet> &enemyBullets,
+                   EventBus &events, bool playerAlive)
 {
+    prevX = x;
+    prevY = y;
+
     if (state == EnemyState::DEAD)
     {
         if (!deathAnimationPlayed)
@@ -41,6 +48,22 @@ void Enemy::update(float dt, const SDL_Rect &playerRect, const std::vector<SDL_R
                 }
             }
         }
+
+        // The blood effect starts after a delay and holds its last frame.
+        if (deadEffectDelayCounter < deadEffectDelayThreshold)
+        {
+            deadEffectDelayCounter++;
+        }
+        else
+        {
+            deadEffectFrameTime++;
+            if (deadEffectFrameTime >= DEAD_EFFECT_SPEED)
+            {
+                if (deadEffectFrame < DEAD_EFFECT_FRAMES - 1)
+                    deadEffectFrame++;
+                deadEffectFrameTime = 0;
+            }
+        }
         return;
     }
 
@@ -70,7 +93,7 @@ void Enemy::update(float dt, const SDL_Rect &playerRect, const std::vector<SDL_R
             // Only attack if enough time has passed.
             if (fireTimer >= weapon->getFireRate())
             {
-                attack(enemyBullets, playerRect);
+                attack(enemyBullets, playerRect, events);
                 fireTimer = 0.0f;
             }
         }
@@ -93,7 +116,7 @@ void Enemy::update(float dt, const SDL_Rect &playerRect, const std::vector<SDL_R
         weapon->update();
 }
 
-void Enemy::patrol(float dt, const std::vector<SDL_Rect> &walls)
+void Enemy::patrol(float dt, const CollisionGrid &walls)
 {
     float newX = x + speed * dt;
     SDL_Rect newBox = collisionBox;
@@ -110,25 +133,24 @@ void Enemy::patrol(float dt, const std::vector<SDL_Rect> &walls)
     angle = (speed > 0) ? 0 : 180;
 }
 
-void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY)
+void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha)
 {
+    int drawX = static_cast<int>(prevX + (x - prevX) * alpha);
+    int drawY = static_cast<int>(prevY + (y - prevY) * alpha);
+
     SDL_Rect dest;
-    dest.x = static_cast<int>(x) - cameraX;
-    dest.y = static_cast<int>(y) - cameraY;
+    dest.x = drawX - cameraX;
+    dest.y = drawY - cameraY;
     dest.w = 54;
     dest.h = 54;
     SDL_Point center = {27, 27};
 
     if (state == EnemyState::DEAD)
     {
-        // Render death effect (unchanged or updated as needed)
-        if (deadEffectDelayCounter < deadEffectDelayThreshold)
-        {
-            deadEffectDelayCounter++;
-        }
-        else
+        // Render death effect once its delay has passed (advanced in update()).
+        if (deadEffectDelayCounter >= deadEffectDelayThreshold)
         {
-            SDL_Texture *effectTex = ResourceManager::loadTexture(renderer, "assets/effect.png");
+            SDL_Texture *effectTex = effectTexture.get();
             if (effectTex)
             {
                 // Adjust effect dimensions if desired (here assuming effect remains 98x54)
@@ -136,8 +158,8 @@ void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY)
                 SDL_Rect effectSrc = {deadEffectFrame * effectWidth, 0, effectWidth, effectHeight};
                 SDL_Rect effectDest;
                 // Center the effect relative to the enemy's original 54x54 hitbox:
-                effectDest.x = static_cast<int>(x) - cameraX - (effectWidth - 54) / 2;
-                effectDest.y = static_cast<int>(y) - cameraY;
+                effectDest.x = drawX - cameraX - (effectWidth - 54) / 2;
+                effectDest.y = drawY - cameraY;
                 effectDest.w = effectWidth;
                 effectDest.h = effectHeight;
 
@@ -147,15 +169,7 @@ void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY)
                 effectDest.x += offsetX;
                 effectDest.y += offsetY;
                 SDL_Point effectCenter = {effectWidth / 2, effectHeight / 2};
-                SDL_RenderCopyEx(renderer, effectTex, &effectSrc, &effectDest, angle, &effectCenter, SDL_FLIP_NONE);
-
-                deadEffectFrameTime++;
-                if (deadEffectFrameTime >= DEAD_EFFECT_SPEED)
-                {
-                    if (deadEffectFrame < DEAD_EFFECT_FRAMES - 1)
-                        deadEffectFrame++;
-                    deadEffectFrameTime = 0;
-                }
+                RenderStats::copyEx(renderer, effectTex, &effectSrc, &effectDest, angle, &effectCenter, SDL_FLIP_NONE);
             }
         }
 
@@ -167,12 +181,12 @@ void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY)
         src.h = 54;
         // Create a destination rectangle that centers the 100x54 image over the enemy’s original 54x54 hitbox.
         SDL_Rect destDead;
-        destDead.x = static_cast<int>(x) - cameraX - (100 - 54) / 2; // Shift horizontally.
-        destDead.y = static_cast<int>(y) - cameraY;                  // Adjust vertical position if needed.
+        destDead.x = drawX - cameraX - (100 - 54) / 2; // Shift horizontally.
+        destDead.y = drawY - cameraY;                  // Adjust vertical position if needed.
         destDead.w = 100;
         destDead.h = 54;
         SDL_Point centerDead = {50, 27}; // Center of 100x54 image.
-        SDL_RenderCopyEx(renderer, deadTexture, &src, &destDead, angle, &centerDead, SDL_FLIP_NONE);
+        RenderStats::copyEx(renderer, deadTexture.get(), &src, &destDead, angle, &centerDead, SDL_FLIP_NONE);
     }
     else if (state == EnemyState::PATROLLING)
     {
@@ -182,33 +196,36 @@ void Enemy::render(SDL_Renderer *renderer, int cameraX, int cameraY)
         src.y = 0;
         src.w = 54;
         src.h = 54;
-        SDL_RenderCopyEx(renderer, enemyRunTexture, &src, &dest, angle, &center, SDL_FLIP_NONE);
+        RenderStats::copyEx(renderer, enemyRunTexture.get(), &src, &dest, angle, &center, SDL_FLIP_NONE);
     }
     else // For ATTACKING, use idle texture.
     {
-        SDL_RenderCopyEx(renderer, enemyIdleTexture, nullptr, &dest, angle, &center, SDL_FLIP_NONE);
+        RenderStats::copyEx(renderer, enemyIdleTexture.get(), nullptr, &dest, angle, &center, SDL_FLIP_NONE);
     }
 
-    int screenX = static_cast<int>(x) - cameraX;
-    int screenY = static_cast<int>(y) - cameraY;
+    int screenX = drawX - cameraX;
+    int screenY = drawY - cameraY;
     if (state != EnemyState::DEAD && weapon)
     {
         weapon->render(renderer, static_cast<float>(screenX), static_cast<float>(screenY), angle, false);
     }
 }
 
-void Enemy::takeDamage(int damage)
+bool Enemy::takeDamage(int damage)
 {
+    if (state == EnemyState::DEAD)
+        return false;
+
     health -= damage;
     if (health <= 0)
     {
         state = EnemyState::DEAD;
-        // Optionally, trigger a death animation here.
-        std::cout << "Enemy died at position (" << x << ", " << y << ")\n";
+        return true;
     }
+    return false;
 }
 
-void Enemy::attack(std::vector<Bullet> &enemyBullets, const SDL_Rect &playerRect)
+void Enemy::attack(std::vector<Bullet> &enemyBullets, const SDL_Rect &playerRect, EventBus &events)
 {
     // Calculate player's center.
     float playerCenterX = playerRect.x + playerRect.w / 2.0f;
@@ -221,11 +238,11 @@ void Enemy::attack(std::vector<Bullet> &enemyBullets, const SDL_Rect &playerRect
 
     if (weapon && weapon->hasAmmo())
     {
-        weapon->shoot(enemyBullets, spawnX, spawnY, playerCenterX, playerCenterY);
+        weapon->shoot(enemyBullets, spawnX, spawnY, playerCenterX, playerCenterY, &events, EventTarget::ENEMY);
     }
 }
 
-std::unique_ptr<AbstractWeapon> Enemy::dropWeapon()
+std::optional<Weapon> Enemy::dropWeapon()
 {
     if (weapon)
     {
@@ -233,5 +250,7 @@ std::unique_ptr<AbstractWeapon> Enemy::dropWeapon()
         // Adjust by 27 (half of 54) assuming the enemy sprite is 54x54.
         weapon->setPosition(x + 27, y + 27);
     }
-    return std::move(weapon);
+    std::optional<Weapon> dropped = std::move(weapon);
+    weapon.reset();
+    return dropped;
 }
@@ -0,0 +1,53 @@
+#include "FrameHistogram.h"
+#include <cstdio>
+
+void FrameHistogram::record(double ms)
+{
+    if (ms < 0.0)
+        ms = 0.0;
+    int bucket = static_cast<int>(ms / BUCKET_MS);
+    buckets[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT]++;
+    count++;
+    totalMs += ms;
+    if (ms > maxMs)
+        maxMs = ms;
+}
+
+void FrameHistogram::reset()
+{
+    buckets.fill(0);
+    count = 0;
+    totalMs = 0.0;
+    maxMs = 0.0;
+}
+
+double FrameHistogram::percentile(double fraction) const
+{
+    if (count == 0)
+        return 0.0;
+
+    // Rank of the sample we are after, 1-based, rounded up.
+    size_t rank = static_cast<size_t>(fraction * count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    size_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // Upper edge of the bucket, but never above what was actually seen.
+            double edge = (i + 1) * BUCKET_MS;
+            return edge < maxMs ? edge : maxMs;
+        }
+    }
+    return maxMs; // In the overflow bucket.
+}
+
+std::string FrameHistogram::summary() const
+{
+    char text[160];
+    std::snprintf(text, sizeof(text), "%zu frames: mean %.2f, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms",
+                  count, getMean(), percentile(0.50), percentile(0.95), percentile(0.99), maxMs);
+    return text;
+}
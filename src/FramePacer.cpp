@@ -0,0 +1,40 @@
+#include "FramePacer.h"
+
+FramePacer::FramePacer(int targetFps)
+    : frequency(static_cast<double>(SDL_GetPerformanceFrequency()))
+{
+    setTargetFps(targetFps);
+}
+
+void FramePacer::setTargetFps(int fps)
+{
+    targetFps = fps > 0 ? fps : 0;
+    periodTicks = targetFps ? frequency / targetFps : 0.0;
+    nextDeadline = 0.0;
+}
+
+void FramePacer::endFrame()
+{
+    if (periodTicks > 0.0)
+    {
+        double now = static_cast<double>(SDL_GetPerformanceCounter());
+        if (nextDeadline == 0.0 || now - nextDeadline > periodTicks)
+            nextDeadline = now + periodTicks; // First frame, or too far behind to catch up.
+
+        for (;;)
+        {
+            double remainingMs = (nextDeadline - static_cast<double>(SDL_GetPerformanceCounter())) * 1000.0 / frequency;
+            if (remainingMs <= 0.0)
+                break;
+            if (remainingMs > SPIN_MS)
+                SDL_Delay(static_cast<Uint32>(remainingMs - SPIN_MS));
+            // Otherwise spin: the remaining time is below the sleep granularity.
+        }
+        nextDeadline += periodTicks;
+    }
+
+    Uint64 frameEnd = SDL_GetPerformanceCounter();
+    if (lastFrameEnd)
+        histogram.record((frameEnd - lastFrameEnd) * 1000.0 / frequency);
+    lastFrameEnd = frameEnd;
+}
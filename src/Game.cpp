@@ -3,9 +3,23 @@
 #include "SDL2/SDL_image.h"
 #include <iostream>
 #include "Constants.h"
+#include "AssetPack.h"
+#include "PixelCache.h"
+#include "SaveGame.h"
+#include "Hash.h"
+#include "RenderStats.h"
+#include "BulletCollision.h"
+#include "CollisionHandler.h"
+#include "FrameHistogram.h"
+#include "Profiler.h"
+#include "Sprites.h"
 #include <cmath>
+#include <algorithm>
+#include <climits>
+#include <fstream>
 
-Game::Game() : running(false), inMenu(true), paused(false), camera{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT} {}
+Game::Game() : running(false), inMenu(true), paused(false), camera{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}, aliveEnemies(0),
+               preloader(PRELOAD_MAX_LEVELS, PRELOAD_MEMORY_BUDGET) {}
 
 Game::~Game()
 {
@@ -14,8 +28,13 @@ Game::~Game()
 
 bool Game::createWindowAndRenderer(const char *title, int width, int height)
 {
+    // Headless: SDL's dummy video driver needs no display, and the software
+    // renderer no GPU; textures still load, nothing is ever presented.
+    if (headless)
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
     SDL_Window *rawWindow = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                             width, height, SDL_WINDOW_SHOWN);
+                                             width, height, headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     if (!rawWindow)
     {
         std::cerr << "Failed to create window: " << SDL_GetError() << std::endl;
@@ -25,7 +44,7 @@ bool Game::createWindowAndRenderer(const char *title, int width, int height)
 
     try
     {
-        renderer = std::make_unique<Renderer>(window.get());
+        renderer = std::make_unique<Renderer>(window.get(), headless);
     }
     catch (const std::runtime_error &e)
     {
@@ -36,82 +55,231 @@ bool Game::createWindowAndRenderer(const char *title, int width, int height)
     return true;
 }
 
-bool Game::init(const char *title, int width, int height)
+namespace
+{
+    // Column and log names, in UpdateSystem order.
+    const char *const UPDATE_SYSTEM_NAMES[] = {"input", "level", "player", "enemies", "bullets", "events", "replay"};
+}
+
+bool Game::init(const char *title, int width, int height, bool headlessMode)
 {
+    headless = headlessMode;
+    PROFILE_THREAD("main");
+    Uint64 initStart = SDL_GetPerformanceCounter();
+
     mapFiles = {"assets/map/map1.json", "assets/map/map2.json", "assets/map/map3.json"};
     currentMapIndex = 0;
 
-    // Clear any previous data.
+    // Clear any previous data. Everything holding texture references (or,
+    // for the preloader, decoding into the cache) goes before the cache.
+    preloader.clear();
+    level.reset();
+    player.reset();
+    menu.reset();
+    pauseMenu.reset();
+    snapshot = LevelSnapshot();
     enemies.clear();
     enemyBullets.clear();
     droppedWeapons.clear();
+    events.clear();
     ResourceManager::clear();
 
+    // Serve assets from the pack when one has been built; loose files otherwise.
+    if (!AssetPack::isMounted())
+        AssetPack::mount(ASSET_PACK_PATH);
+    PixelCache::setDirectory(PIXEL_CACHE_DIR);
+    rng.setSeed(SDL_GetPerformanceCounter());
+
     if (!createWindowAndRenderer(title, width, height))
         return false;
 
     SDL_Renderer *sdlRenderer = renderer->getSDLRenderer();
     menu = std::make_unique<Menu>(sdlRenderer);
-    level = std::make_unique<Level>(sdlRenderer, mapFiles[currentMapIndex]);
-    player = std::make_unique<Player>(sdlRenderer, level.get());
 
-    spawnEnemies(sdlRenderer);
+    // Decode gameplay sprites and parse the first map while the menu is up;
+    // the level itself is swapped in when the player leaves the menu.
+    ResourceManager::prefetchTextures(Sprites::gameplaySprites());
+    preloader.request(currentMapIndex, mapFiles[currentMapIndex]);
 
     inMenu = true;
     paused = false;
-    pauseMenu.reset();
     returnToMainMenu = false;
 
     running = true;
+    SDL_Log("Game::init ready in %.2f ms",
+            (SDL_GetPerformanceCounter() - initStart) * 1000.0 / SDL_GetPerformanceFrequency());
+    return true;
+}
+
+void Game::captureSnapshot()
+{
+    snapshot.mapIndex = currentMapIndex;
+    snapshot.player = *player;
+    snapshot.enemies.clear();
+    for (const auto &enemy : enemies)
+        snapshot.enemies.push_back(*enemy);
+    snapshot.droppedWeapons = droppedWeapons;
+}
+
+bool Game::restoreSnapshot()
+{
+    // Entities are assigned in place, so nothing is allocated or looked up;
+    // only texture reference counts change.
+    if (snapshot.mapIndex != currentMapIndex || !level || levelMapIndex != currentMapIndex ||
+        !player || enemies.size() != snapshot.enemies.size())
+        return false;
+
+    *player = *snapshot.player;
+    for (size_t i = 0; i < enemies.size(); i++)
+        *enemies[i] = snapshot.enemies[i];
+    droppedWeapons = snapshot.droppedWeapons;
+    aliveEnemies = static_cast<int>(enemies.size());
+    enemyBullets.clear();
+    events.clear();
     return true;
 }
 
 void Game::restartLevel(SDL_Renderer *sdlRenderer)
 {
-    // Clear level-specific objects.
+    PROFILE_SCOPE("Game::restartLevel");
+    Uint64 restartStart = SDL_GetPerformanceCounter();
+    pendingInput = InputCommand(); // Clicks from before the restart do not carry over.
+
+    if (restoreSnapshot())
+    {
+        SDL_Log("Level %d restored in %.1f us", currentMapIndex + 1,
+                (SDL_GetPerformanceCounter() - restartStart) * 1000000.0 / SDL_GetPerformanceFrequency());
+        return;
+    }
+
+    // Keep the old player and enemies (and so their texture references)
+    // alive until the new ones exist, so no sprite drops to zero references
+    // and becomes eligible for eviction in between.
+    std::unique_ptr<Player> previousPlayer = std::move(player);
+    std::vector<std::unique_ptr<Enemy>> previousEnemies = std::move(enemies);
     enemies.clear();
     enemyBullets.clear();
     droppedWeapons.clear();
+    events.clear();
+
+    // Level data is never modified during play, so restarting the same map
+    // keeps it as is. Otherwise swap in the preloaded copy if there is one,
+    // or load it now; tilesets shared with the previous map are still
+    // referenced by it at that point and are not decoded again.
+    if (!level || levelMapIndex != currentMapIndex)
+    {
+        std::unique_ptr<Level> preloaded = preloader.take(currentMapIndex, sdlRenderer);
+        if (preloaded)
+            level = std::move(preloaded);
+        else
+            level = std::make_unique<Level>(sdlRenderer, mapFiles[currentMapIndex]);
+        levelMapIndex = currentMapIndex;
+    }
 
-    // Reinitialize the level using the current map.
-    level = std::make_unique<Level>(sdlRenderer, mapFiles[currentMapIndex]);
+    // Start preparing the following map while this one is played.
+    if (currentMapIndex + 1 < static_cast<int>(mapFiles.size()))
+        preloader.request(currentMapIndex + 1, mapFiles[currentMapIndex + 1]);
 
     // Reinitialize the player.
     player = std::make_unique<Player>(sdlRenderer, level.get());
 
     // Respawn enemies for the new level.
     spawnEnemies(sdlRenderer);
+    captureSnapshot();
+
+    SDL_Log("Level %d ready in %.2f ms", currentMapIndex + 1,
+            (SDL_GetPerformanceCounter() - restartStart) * 1000.0 / SDL_GetPerformanceFrequency());
+}
+
+void Game::quickSave()
+{
+    Uint64 saveStart = SDL_GetPerformanceCounter();
+    if (SaveGame::save(*this, QUICKSAVE_PATH))
+        SDL_Log("Quicksaved in %.1f us",
+                (SDL_GetPerformanceCounter() - saveStart) * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+
+void Game::quickLoad()
+{
+    if (replay.isRecording() || replay.isPlaying())
+    {
+        SDL_Log("Quickload is disabled while recording or replaying");
+        return;
+    }
+
+    Uint64 loadStart = SDL_GetPerformanceCounter();
+    if (!SaveGame::load(*this, QUICKSAVE_PATH))
+        return;
+    resetInterpolation(); // Do not blend from the pre-load state.
+    SDL_Log("Quickloaded in %.1f us",
+            (SDL_GetPerformanceCounter() - loadStart) * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+
+int Game::getRefreshRate() const
+{
+    SDL_DisplayMode mode;
+    int display = SDL_GetWindowDisplayIndex(window.get());
+    if (display < 0 || SDL_GetCurrentDisplayMode(display, &mode) != 0)
+        return 0;
+    return mode.refresh_rate;
 }
 
-void Game::processGameInput(SDL_Event &event)
+void Game::resetInterpolation()
 {
-    if (event.type == SDL_QUIT)
+    previousCamera = {camera.x, camera.y};
+    player->resetInterpolation();
+    for (Bullet &bullet : player->getBullets())
+        bullet.resetInterpolation();
+    for (auto &enemy : enemies)
+        enemy->resetInterpolation();
+    for (Bullet &bullet : enemyBullets)
+        bullet.resetInterpolation();
+}
+
+InputCommand Game::collectInput()
+{
+    InputCommand command = pendingInput;
+    pendingInput = InputCommand();
+    InputManager::sampleHeld(command, camera.x, camera.y);
+    return command;
+}
+
+void Game::applyInput(const InputCommand &command)
+{
+    if (command.wasPressed(InputAction::RESTART) && player->isDead())
+    {
+        restartLevel(renderer->getSDLRenderer());
+        return;
+    }
+
+    player->updateInput(command);
+
+    float playerCenterX = player->getX() + player->getWidth() / 2;
+    float playerCenterY = player->getY() + player->getHeight() / 2;
+    if (!player->isDead())
     {
-        running = false;
+        float targetAngle = atan2(command.aimY - playerCenterY, command.aimX - playerCenterX) * (180.0 / M_PI);
+        player->setAngle(targetAngle);
     }
-    // Process left-click for shooting.
-    else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT)
+
+    // Left click: shoot toward where the cursor was when clicked.
+    if (command.wasPressed(InputAction::FIRE))
     {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        player->shoot(mouseX, mouseY, camera.x, camera.y);
+        const InputPress &press = command.press(InputAction::FIRE);
+        player->shoot(press.x, press.y, events);
     }
-    // Process right-click for pickup/throw.
-    else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_RIGHT)
+    // Right click: pickup/throw.
+    if (command.wasPressed(InputAction::USE))
     {
         // Determine player's center.
-        SDL_Point playerCenter = {static_cast<int>(player->getX() + player->getWidth() / 2),
-                                  static_cast<int>(player->getY() + player->getHeight() / 2)};
+        SDL_Point playerCenter = {static_cast<int>(playerCenterX), static_cast<int>(playerCenterY)};
 
         if (player->getWeapons()->hasWeapon())
         {
-            // Calculate throw position based on mouse.
-            int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
-            float playerCenterX = player->getX() + player->getWidth() / 2;
-            float playerCenterY = player->getY() + player->getHeight() / 2;
-            float dx = static_cast<float>(mouseX + camera.x) - playerCenterX;
-            float dy = static_cast<float>(mouseY + camera.y) - playerCenterY;
+            // Calculate throw position based on where the cursor was.
+            const InputPress &press = command.press(InputAction::USE);
+            float dx = press.x - playerCenterX;
+            float dy = press.y - playerCenterY;
             float len = std::sqrt(dx * dx + dy * dy);
             if (len == 0)
                 len = 1;
@@ -124,44 +292,34 @@ void Game::processGameInput(SDL_Event &event)
             if (dropped)
             {
                 // The dropped weapon is now set at the throw position.
-                droppedWeapons.push_back(std::move(dropped));
+                events.weaponDrops.push({dropped->getType(), dropped->getX(), dropped->getY()});
+                droppedWeapons.push_back(std::move(*dropped));
             }
         }
         else
         {
             // No weapon held: attempt to pick up a nearby dropped weapon.
             SDL_Rect pickupRect = {playerCenter.x - 16, playerCenter.y - 16, 32, 32};
-            for (auto it = droppedWeapons.begin(); it != droppedWeapons.end();)
+            for (auto it = droppedWeapons.begin(); it != droppedWeapons.end(); ++it)
             {
-                if (*it)
-                {
-                    SDL_Rect weaponRect = {static_cast<int>((*it)->getX()),
-                                           static_cast<int>((*it)->getY()),
-                                           32, 32}; // Adjust pickup area as needed.
-                    if (SDL_HasIntersection(&weaponRect, &pickupRect))
-                    {
-                        // Pickup the first weapon found.
-                        player->getWeapons()->pickupWeapon(std::move(*it), renderer->getSDLRenderer());
-                        it = droppedWeapons.erase(it);
-                        break; // Exit loop: only one weapon should be picked up.
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
-                else
+                SDL_Rect weaponRect = {static_cast<int>(it->getX()),
+                                       static_cast<int>(it->getY()),
+                                       32, 32}; // Adjust pickup area as needed.
+                if (SDL_HasIntersection(&weaponRect, &pickupRect))
                 {
-                    ++it;
+                    // Pickup the first weapon found.
+                    player->getWeapons()->pickupWeapon(std::move(*it), renderer->getSDLRenderer());
+                    droppedWeapons.erase(it);
+                    break; // Exit loop: only one weapon should be picked up.
                 }
             }
         }
     }
-    // Additional game-specific event processing can be added here.
 }
 
 void Game::handleEvents()
 {
+    PROFILE_SCOPE("Game::handleEvents");
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -169,6 +327,11 @@ void Game::handleEvents()
         if (inMenu)
         {
             menu->handleEvents(event, running, inMenu, returnToMainMenu);
+            if (!inMenu && !level)
+            {
+                // First start: build the level from the prefetched assets.
+                restartLevel(renderer->getSDLRenderer());
+            }
             continue;
         }
 
@@ -207,32 +370,37 @@ void Game::handleEvents()
             continue;
         }
 
-        // If not paused, process game input normally.
-        if (player->isDead() && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_r)
+        // Quicksave / quickload; loading also works after dying.
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F5)
         {
-            restartLevel(renderer->getSDLRenderer());
+            quickSave();
             continue;
         }
-
-        processGameInput(event);
-        const Uint8 *keys = SDL_GetKeyboardState(nullptr);
-        player->updateInput(keys);
-        if (!player->isDead())
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F9)
         {
-            int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
-            float playerCenterX = player->getX() + (player->getWidth() / 2);
-            float playerCenterY = player->getY() + (player->getHeight() / 2);
-            float dx = (mouseX + camera.x) - playerCenterX;
-            float dy = (mouseY + camera.y) - playerCenterY;
-            float targetAngle = atan2(dy, dx) * (180.0 / M_PI);
-            player->setAngle(targetAngle);
+            quickLoad();
+            continue;
+        }
+        // F10: dump the profiler zones recorded so far.
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F10)
+        {
+            Profiler::writeTrace(PROFILE_TRACE_PATH);
+            continue;
         }
+
+        // Clicks and R are queued for the next tick; held keys and aim are sampled there.
+        if (event.type == SDL_QUIT)
+            running = false;
+        else
+            InputManager::recordPress(pendingInput, event, camera.x, camera.y);
     }
 }
 
 void Game::update()
 {
+    PROFILE_SCOPE("Game::update");
+    preloader.poll();
+
     if (!inMenu && paused)
     {
         // Optionally update pause menu animations here.
@@ -241,6 +409,29 @@ void Game::update()
 
     if (!inMenu)
     {
+        // Time each part of the tick; see logUpdateTimings().
+        Uint64 systemStart = SDL_GetPerformanceCounter();
+        auto endSystem = [&](UpdateSystem system)
+        {
+            Uint64 now = SDL_GetPerformanceCounter();
+            updateTimings.counts[static_cast<int>(system)] += now - systemStart;
+            systemStart = now;
+        };
+        updateTimings.ticks++;
+
+        previousCamera = {camera.x, camera.y};
+
+        // Exactly one input command per tick. During playback the recorded
+        // command replaces live input, which is still drained.
+        InputCommand command = collectInput();
+        if (replay.isPlaying() && !replay.next(command))
+        {
+            finishReplay();
+            return;
+        }
+        applyInput(command);
+        endSystem(UpdateSystem::INPUT);
+
         // Basic camera smoothing: interpolate current camera position toward desired position.
         int desiredX = player->getX() - camera.w / 2;
         int desiredY = player->getY() - camera.h / 2;
@@ -248,6 +439,10 @@ void Game::update()
         camera.x = static_cast<int>(camera.x + smoothingFactor * (desiredX - camera.x));
         camera.y = static_cast<int>(camera.y + smoothingFactor * (desiredY - camera.y));
 
+        // Stream in the chunks of infinite maps around the new view.
+        level->update({camera.x, camera.y, camera.w, camera.h});
+        endSystem(UpdateSystem::LEVEL);
+
         // Update player state.
         player->update(SCREEN_WIDTH, SCREEN_HEIGHT);
 
@@ -276,128 +471,385 @@ void Game::update()
             SDL_Rect meleeArea = {static_cast<int>(player->getX()) + PLAYER_COLLISION_OFFSET_X,
                                   static_cast<int>(player->getY()) + PLAYER_COLLISION_OFFSET_Y,
                                   PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT};
-            for (auto &enemy : enemies)
+            for (size_t i = 0; i < enemies.size(); i++)
             {
-                SDL_Rect enemyBox = enemy->getCollisionBox();
-                if (!enemy->isDead() && SDL_HasIntersection(&meleeArea, &enemyBox))
+                SDL_Rect enemyBox = enemies[i]->getCollisionBox();
+                if (!enemies[i]->isDead() && SDL_HasIntersection(&meleeArea, &enemyBox))
                 {
-                    enemy->takeDamage(9999); // Instantly kill enemy.
+                    events.damage.push({EventTarget::ENEMY, static_cast<int>(i), 9999}); // Instantly kill enemy.
                 }
             }
         }
 
-        // Update each enemy.
-        // Pass a fixed delta time (1/60 seconds), the player's rectangle, and level wall collisions.
-        for (auto &enemy : enemies)
-        {
-            enemy->update(1.0f / 60.0f, playerRect, level->getCollisionTiles(), enemyBullets, !player->isDead());
-        }
-
-        // Drop weapons from dead enemies.
-        for (auto &enemy : enemies)
-        {
-            if (enemy->isDead() && enemy->hasWeapon())
-            {
-                droppedWeapons.push_back(enemy->dropWeapon());
-            }
-        }
+        endSystem(UpdateSystem::PLAYER);
 
-        // Update enemy bullets.
-        for (auto &bullet : enemyBullets)
+        // Update each enemy.
+        // Pass the tick length, the player's rectangle, and level wall collisions.
         {
-            bullet.update(1.0f, SCREEN_WIDTH, SCREEN_HEIGHT);
+            PROFILE_SCOPE("Game::update enemies");
+            for (auto &enemy : enemies)
+                enemy->update(FIXED_TIMESTEP, playerRect, level->getCollisionGrid(), enemyBullets, events, !player->isDead());
         }
+        endSystem(UpdateSystem::ENEMIES);
 
-        // Check enemy bullet collision with the player.
-        // Use the player's collision box (using the same offsets as for the player).
+        // Update enemy bullets, then resolve every bullet against walls and targets.
+        BulletCollision::move(enemyBullets, FIXED_TIMESTEP);
         SDL_Rect playerCollision = {static_cast<int>(player->getX()) + PLAYER_COLLISION_OFFSET_X,
                                     static_cast<int>(player->getY()) + PLAYER_COLLISION_OFFSET_Y,
                                     PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT};
+        BulletCollision::hitPlayer(enemyBullets, playerCollision, level->getCollisionGrid(), events);
+        BulletCollision::hitEnemies(player->getBullets(), enemies, level->getCollisionGrid(), events);
 
-        for (auto &bullet : enemyBullets)
-        {
-            SDL_Rect bulletRect = {static_cast<int>(bullet.getX()), static_cast<int>(bullet.getY()), 5, 5};
+        BulletCollision::removeInactive(player->getBullets());
+        BulletCollision::removeInactive(enemyBullets);
+        endSystem(UpdateSystem::BULLETS);
 
-            // Check collision with walls:
-            for (const auto &wall : level->getCollisionTiles())
-            {
-                if (SDL_HasIntersection(&bulletRect, &wall))
-                {
-                    bullet.deactivate();
-                    break; // No need to check further walls for this bullet.
-                }
-            }
+        processEvents();
 
-            if (SDL_HasIntersection(&playerCollision, &bulletRect))
-            {
-                player->takeDamage(9999);
-                bullet.deactivate();
-            }
+        // Stress runs stay on their map, even with no enemies to clear.
+        if (aliveEnemies == 0 && currentMapIndex < static_cast<int>(mapFiles.size()) - 1 && !stressPopulation)
+        {
+            currentMapIndex++;
+            restartLevel(renderer->getSDLRenderer());
         }
+        endSystem(UpdateSystem::EVENTS);
 
-        auto &bullets = player->getBullets();
-        SDL_Rect bulletRect;
-        for (auto &bullet : bullets)
+        if (replay.isRecording())
         {
-            bulletRect.x = static_cast<int>(bullet.getX());
-            bulletRect.y = static_cast<int>(bullet.getY());
-            bulletRect.w = 5;
-            bulletRect.h = 5;
+            replay.record(command, stateChecksum());
+        }
+        else if (replay.isPlaying())
+        {
+            bool wasInSync = replay.getDesyncTick() < 0;
+            if (!replay.verify(stateChecksum()) && wasInSync)
+                SDL_Log("Replay desynced at tick %ld", replay.getDesyncTick());
+        }
+        endSystem(UpdateSystem::REPLAY);
+    }
+}
 
-            // Check collision with walls:
-            for (const auto &wall : level->getCollisionTiles())
-            {
-                if (SDL_HasIntersection(&bulletRect, &wall))
-                {
-                    bullet.deactivate();
-                    break; // No need to check further walls for this bullet.
-                }
-            }
+bool Game::runHeadless(long tickCount)
+{
+    // Without a replay, play the current map with a fixed seed and no input.
+    bool replaying = replay.isPlaying();
+    if (!replaying)
+        beginSession(HEADLESS_SEED, currentMapIndex);
+
+    updateTimings = UpdateTimings();
+    Uint64 start = SDL_GetPerformanceCounter();
+    long ticks = 0;
+    while (running && (replay.isPlaying() || ticks < tickCount))
+    {
+        update();
+        ticks++;
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / static_cast<double>(SDL_GetPerformanceFrequency());
+    if (replaying)
+        ticks = static_cast<long>(replay.getTick()); // The last update() only found the end.
+
+    SDL_Log("Headless: %ld ticks in %.3f s, %.0f ticks/s (%.1fx real time)", ticks, seconds,
+            ticks / seconds, ticks / seconds / SIMULATION_HZ);
+    logUpdateTimings();
+    return !replaying || replay.getDesyncTick() < 0;
+}
 
-            // Check collision with enemies:
-            for (auto &enemy : enemies)
-            {
-                SDL_Rect enemyBox = enemy->getCollisionBox();
-                if (!enemy->isDead() && SDL_HasIntersection(&bulletRect, &enemyBox))
-                {
-                    enemy->takeDamage(9999); // Instantly kill enemy.
-                    bullet.deactivate();
-                    break; // Exit loop since bullet is deactivated.
-                }
-            }
-        }
+bool Game::randomOpenPoint(float &x, float &y)
+{
+    // A few tries for a spot where a character-sized box is clear of walls;
+    // dense maps may still end up with something inside a wall.
+    SDL_Rect bounds = level->getBounds();
+    for (int attempt = 0; attempt < 32; attempt++)
+    {
+        x = bounds.x + rng.nextFloat() * (bounds.w - PLAYER_SPRITE_WIDTH);
+        y = bounds.y + rng.nextFloat() * (bounds.h - PLAYER_SPRITE_HEIGHT);
+        SDL_Rect box = {static_cast<int>(x) + PLAYER_COLLISION_OFFSET_X, static_cast<int>(y) + PLAYER_COLLISION_OFFSET_Y,
+                        PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT};
+        if (!CollisionHandler::checkCollision(box, level->getCollisionGrid()))
+            return true;
+    }
+    return false;
+}
+
+void Game::spawnStressPopulation(SDL_Renderer *renderer)
+{
+    float x, y;
+    for (int i = 0; i < stressPopulation->enemies; i++)
+    {
+        randomOpenPoint(x, y);
+        enemies.push_back(std::make_unique<Enemy>(x, y, renderer));
+    }
+    for (int i = 0; i < stressPopulation->bosses; i++)
+    {
+        randomOpenPoint(x, y);
+        enemies.push_back(std::make_unique<BossEnemy>(x, y, renderer));
+    }
+    aliveEnemies = static_cast<int>(enemies.size());
+
+    for (int i = 0; i < stressPopulation->weapons; i++)
+    {
+        randomOpenPoint(x, y);
+        Weapon weapon = i % 2 ? Weapon(MeleeWeapon(WeaponType::BASEBALL_BAT, WEAPON_FIRE_RATE_MELEE, 5))
+                              : Weapon(ProjectileWeapon(WeaponType::SHOTGUN, WEAPON_AMMO_SHOTGUN, WEAPON_FIRE_RATE_SHOTGUN,
+                                                        WEAPON_BULLET_SPEED_SHOTGUN, 10));
+        weapon.initialize(renderer);
+        weapon.setPosition(x, y);
+        droppedWeapons.push_back(std::move(weapon));
+    }
+}
+
+void Game::topUpStressBullets()
+{
+    // Bullet::update retires bullets outside the first screen of the world,
+    // so new ones start inside it to live for a while.
+    SDL_Rect area = level->getBounds();
+    SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    if (!SDL_IntersectRect(&area, &screen, &area))
+        area = screen;
+
+    while (static_cast<int>(enemyBullets.size()) < stressPopulation->bullets)
+    {
+        float angle = rng.nextFloat() * 6.2831853f;
+        enemyBullets.emplace_back(area.x + rng.nextFloat() * area.w, area.y + rng.nextFloat() * area.h,
+                                  std::cos(angle), std::sin(angle), WEAPON_BULLET_SPEED_SHOTGUN);
+    }
 
-        // Remove deactivated bullets.
-        bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-                                     [](const Bullet &b)
-                                     { return !b.isActive(); }),
-                      bullets.end());
+    // Player bullets go through BulletCollision::hitEnemies, against every enemy.
+    std::vector<Bullet> &playerBullets = player->getBullets();
+    while (static_cast<int>(playerBullets.size()) < stressPopulation->playerBullets)
+    {
+        float angle = rng.nextFloat() * 6.2831853f;
+        playerBullets.emplace_back(area.x + rng.nextFloat() * area.w, area.y + rng.nextFloat() * area.h,
+                                   std::cos(angle), std::sin(angle), WEAPON_BULLET_SPEED_PISTOL);
+    }
+}
 
-        enemyBullets.erase(std::remove_if(enemyBullets.begin(), enemyBullets.end(),
-                                          [](const Bullet &b)
-                                          { return !b.isActive(); }),
-                           enemyBullets.end());
+bool Game::runStress(const StressPopulation &largest, int steps, long ticksPerStep, int mapIndex, const std::string &csvPath)
+{
+    if (mapIndex < 0 || mapIndex >= static_cast<int>(mapFiles.size()))
+    {
+        std::cerr << "No map " << mapIndex << " to stress" << std::endl;
+        return false;
+    }
+    std::ofstream csv(csvPath, std::ios::trunc);
+    if (!csv)
+    {
+        std::cerr << "Failed to open " << csvPath << std::endl;
+        return false;
+    }
+    csv << "enemies,bosses,bullets,player_bullets,weapons,ticks,live_enemies,live_bullets,mean_ms,p50_ms,p95_ms,max_ms";
+    for (const char *name : UPDATE_SYSTEM_NAMES)
+        csv << "," << name << "_us";
+    csv << "\n";
 
-        bool anyAlive = false;
-        for (const auto &enemy : enemies)
+    const double microsPerCount = 1000000.0 / SDL_GetPerformanceFrequency();
+    for (int step = 0; step < steps; step++)
+    {
+        // Halve the population for every step before the last, rounding up
+        // so small populations do not vanish. Past 30 halvings every count
+        // is down to 1 anyway, and a wider shift would overflow.
+        int divisor = 1 << std::min(steps - 1 - step, 30);
+        StressPopulation population;
+        population.enemies = (largest.enemies + divisor - 1) / divisor;
+        population.bosses = (largest.bosses + divisor - 1) / divisor;
+        population.bullets = (largest.bullets + divisor - 1) / divisor;
+        population.playerBullets = (largest.playerBullets + divisor - 1) / divisor;
+        population.weapons = (largest.weapons + divisor - 1) / divisor;
+
+        // The snapshot holds the previous population; load this one fresh.
+        stressPopulation = population;
+        snapshot.mapIndex = -1;
+        beginSession(STRESS_SEED, mapIndex);
+
+        // A dead player stops shooting and being shot at, so keep them alive.
+        player->setInvulnerable(true);
+
+        FrameHistogram tickTimes;
+        updateTimings = UpdateTimings();
+        double liveEnemies = 0.0, liveBullets = 0.0;
+        for (long tick = 0; tick < ticksPerStep && running; tick++)
         {
-            if (!enemy->isDead())
-            {
-                anyAlive = true;
-                break;
-            }
+            topUpStressBullets();
+
+            // Swing every tick, barefisted, so the melee check runs against
+            // every enemy as well.
+            InputPress swing;
+            swing.x = player->getX();
+            swing.y = player->getY();
+            pendingInput.setPressed(InputAction::FIRE, swing);
+            liveEnemies += aliveEnemies;
+            liveBullets += enemyBullets.size() + player->getBullets().size();
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            update();
+            tickTimes.record((SDL_GetPerformanceCounter() - start) * microsPerCount / 1000.0);
         }
 
-        if (!anyAlive && currentMapIndex < static_cast<int>(mapFiles.size()) - 1)
+        size_t ticks = tickTimes.getCount();
+        if (ticks == 0)
+            break;
+        SDL_Log("Stress %d enemies, %d bosses, %d bullets, %d player bullets, %d weapons: %s", population.enemies,
+                population.bosses, population.bullets, population.playerBullets, population.weapons,
+                tickTimes.summary().c_str());
+        csv << population.enemies << "," << population.bosses << "," << population.bullets << ","
+            << population.playerBullets << "," << population.weapons
+            << "," << ticks << "," << liveEnemies / ticks << "," << liveBullets / ticks << "," << tickTimes.getMean()
+            << "," << tickTimes.percentile(0.5) << "," << tickTimes.percentile(0.95) << "," << tickTimes.getMax();
+        for (Uint64 count : updateTimings.counts)
+            csv << "," << count * microsPerCount / ticks;
+        csv << "\n";
+    }
+
+    stressPopulation.reset();
+    snapshot.mapIndex = -1;
+    SDL_Log("Stress results written to %s", csvPath.c_str());
+    return static_cast<bool>(csv);
+}
+
+void Game::logUpdateTimings() const
+{
+    Uint64 total = 0;
+    for (Uint64 count : updateTimings.counts)
+        total += count;
+    if (updateTimings.ticks == 0 || total == 0)
+        return;
+
+    double microsPerCount = 1000000.0 / SDL_GetPerformanceFrequency();
+    for (int i = 0; i < static_cast<int>(UpdateSystem::COUNT); i++)
+    {
+        SDL_Log("  %-8s %8.2f us/tick %5.1f%%", UPDATE_SYSTEM_NAMES[i],
+                updateTimings.counts[i] * microsPerCount / updateTimings.ticks, 100.0 * updateTimings.counts[i] / total);
+    }
+    SDL_Log("  %-8s %8.2f us/tick", "total", total * microsPerCount / updateTimings.ticks);
+}
+
+std::uint32_t Game::stateChecksum()
+{
+    // Everything a save holds is simulation state, so hash exactly that.
+    SaveGame::write(*this, checksumBuffer);
+    return static_cast<std::uint32_t>(hashBytes(checksumBuffer.data(), checksumBuffer.size()));
+}
+
+void Game::beginSession(std::uint64_t seed, int mapIndex)
+{
+    rng.setSeed(seed);
+    currentMapIndex = mapIndex;
+    inMenu = false;
+    paused = false;
+    pauseMenu.reset();
+    camera.x = camera.y = 0;
+    previousCamera = {0, 0};
+    stats = GameStats();
+    restartLevel(renderer->getSDLRenderer());
+}
+
+bool Game::startRecording(const std::string &path)
+{
+    recordPath = path;
+    std::uint64_t seed = SDL_GetPerformanceCounter();
+    replay.startRecording(seed, currentMapIndex);
+    beginSession(seed, currentMapIndex);
+    SDL_Log("Recording to %s", path.c_str());
+    return true;
+}
+
+bool Game::startReplay(const std::string &path)
+{
+    if (!replay.load(path))
+        return false;
+    if (replay.getMapIndex() < 0 || replay.getMapIndex() >= static_cast<int>(mapFiles.size()))
+    {
+        std::cerr << "Replay " << path << " starts on unknown map " << replay.getMapIndex() << std::endl;
+        replay.stop();
+        return false;
+    }
+    beginSession(replay.getSeed(), replay.getMapIndex());
+    replayStart = SDL_GetPerformanceCounter();
+    SDL_Log("Replaying %s: %zu ticks from map %d", path.c_str(), replay.getTickCount(), replay.getMapIndex() + 1);
+    return true;
+}
+
+void Game::finishReplay()
+{
+    double seconds = (SDL_GetPerformanceCounter() - replayStart) / static_cast<double>(SDL_GetPerformanceFrequency());
+    if (replay.getDesyncTick() < 0)
+        SDL_Log("Replay finished in sync: %zu ticks in %.2f s", replay.getTickCount(), seconds);
+    else
+        SDL_Log("Replay finished, desynced from tick %ld of %zu", replay.getDesyncTick(), replay.getTickCount());
+    replay.stop();
+    running = false;
+}
+
+void Game::processEvents()
+{
+    // Apply damage; kills become death events.
+    events.damage.drain([this](const DamageEvent &event)
+                        {
+        if (event.target == EventTarget::PLAYER)
         {
-            currentMapIndex++;
-            restartLevel(renderer->getSDLRenderer());
+            player->takeDamage(event.amount);
+            return;
         }
+        Enemy &enemy = *enemies[event.enemyIndex];
+        if (enemy.takeDamage(event.amount))
+            events.deaths.push({event.enemyIndex, enemy.getX(), enemy.getY()}); });
+
+    // Dead enemies drop their weapons.
+    events.deaths.drain([this](const DeathEvent &event)
+                        {
+        aliveEnemies--;
+        stats.kills++;
+        Enemy &enemy = *enemies[event.enemyIndex];
+        if (enemy.hasWeapon())
+        {
+            Weapon weapon = std::move(*enemy.dropWeapon());
+            events.weaponDrops.push({weapon.getType(), weapon.getX(), weapon.getY()});
+            droppedWeapons.push_back(std::move(weapon));
+        } });
+
+    events.weaponDrops.drain([this](const WeaponDroppedEvent &)
+                             { stats.weaponsDropped++; });
+    events.shotsFired.drain([this](const ShotFiredEvent &)
+                            { stats.shotsFired++; });
+}
+
+void Game::render(float alpha)
+{
+    PROFILE_SCOPE("Game::render");
+    drawFrame(alpha);
+    renderer->present();
+}
+
+SDL_Surface *Game::captureFrame()
+{
+    // Background decodes finish in their own time; wait for all of them so
+    // no sprite is missing from the frame.
+    SDL_Renderer *sdlRenderer = renderer->getSDLRenderer();
+    while (ResourceManager::hasPendingTextures())
+    {
+        if (ResourceManager::uploadPendingTextures(sdlRenderer, INT_MAX) == 0)
+            SDL_Delay(1);
+    }
+    drawFrame(1.0f);
+
+    int width = 0, height = 0;
+    SDL_GetRendererOutputSize(sdlRenderer, &width, &height);
+    SDL_Surface *frame = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!frame || SDL_RenderReadPixels(sdlRenderer, nullptr, SDL_PIXELFORMAT_ARGB8888, frame->pixels, frame->pitch) != 0)
+    {
+        std::cerr << "Failed to read back the frame: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(frame);
+        return nullptr;
     }
+    return frame;
 }
 
-void Game::render()
+void Game::drawFrame(float alpha)
 {
+    RenderStats::beginFrame(renderer->getSDLRenderer());
+
+    // Turn a few background-decoded images into textures each frame.
+    ResourceManager::uploadPendingTextures(renderer->getSDLRenderer(), TEXTURE_UPLOADS_PER_FRAME);
+
     renderer->clear();
 
     if (inMenu)
@@ -406,29 +858,33 @@ void Game::render()
     }
     else
     {
-        level->render(renderer->getSDLRenderer(), camera.x, camera.y);
-        renderEnemies(renderer->getSDLRenderer(), camera.x, camera.y);
+        // Nothing moves while paused, so draw the last tick as it is.
+        if (paused)
+            alpha = 1.0f;
+        int cameraX = static_cast<int>(previousCamera.x + (camera.x - previousCamera.x) * alpha);
+        int cameraY = static_cast<int>(previousCamera.y + (camera.y - previousCamera.y) * alpha);
+
+        level->render(renderer->getSDLRenderer(), cameraX, cameraY);
+        renderEnemies(renderer->getSDLRenderer(), cameraX, cameraY, alpha);
 
         for (auto &weapon : droppedWeapons)
         {
-            if (!weapon)
-                continue;
             // Get weapon's world position
-            float weaponX = weapon->getX();
-            float weaponY = weapon->getY();
+            float weaponX = weapon.getX();
+            float weaponY = weapon.getY();
 
             // Convert to screen coordinates using camera offset
-            int screenX = static_cast<int>(weaponX - camera.x);
-            int screenY = static_cast<int>(weaponY - camera.y);
+            int screenX = static_cast<int>(weaponX - cameraX);
+            int screenY = static_cast<int>(weaponY - cameraY);
 
             // Render as dropped
-            weapon->render(renderer->getSDLRenderer(), static_cast<float>(screenX), static_cast<float>(screenY), 0.0f, true);
+            weapon.render(renderer->getSDLRenderer(), static_cast<float>(screenX), static_cast<float>(screenY), 0.0f, true);
         }
 
-        player->render(renderer->getSDLRenderer(), camera.x, camera.y);
+        player->render(renderer->getSDLRenderer(), cameraX, cameraY, alpha);
 
         for (auto &bullet : enemyBullets)
-            bullet.render(renderer->getSDLRenderer(), camera.x, camera.y);
+            bullet.render(renderer->getSDLRenderer(), cameraX, cameraY, alpha);
 
         // If paused, overlay the pause menu.
         if (paused && pauseMenu)
@@ -437,23 +893,40 @@ void Game::render()
             SDL_SetRenderDrawBlendMode(renderer->getSDLRenderer(), SDL_BLENDMODE_BLEND);
             SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 0, 0, 0, 150);
             SDL_Rect overlay = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-            SDL_RenderFillRect(renderer->getSDLRenderer(), &overlay);
+            RenderStats::fillRect(renderer->getSDLRenderer(), &overlay);
             pauseMenu->render();
         }
     }
-
-    renderer->present();
 }
 
 void Game::clean()
 {
-    // Clear enemy objects and bullets.
+    if (replay.isRecording())
+    {
+        if (replay.save(recordPath))
+            SDL_Log("Recorded %zu ticks to %s", replay.getTickCount(), recordPath.c_str());
+        replay.stop();
+    }
+
+    // Release every texture reference before the cache is destroyed.
     enemies.clear();
     enemyBullets.clear();
     droppedWeapons.clear();
+    player.reset();
+    level.reset();
+    menu.reset();
+    pauseMenu.reset();
+    preloader.clear();
+
+    SDL_Log("Textures: %zu KB resident (budget %zu KB), %d evicted this session",
+            ResourceManager::getResidentTextureBytes() / 1024, ResourceManager::getTextureBudget() / 1024,
+            ResourceManager::getEvictionCount());
 
     // Clear ResourceManager to free all textures.
     ResourceManager::clear();
+    // Asset threads are stopped now, so nothing reads the mapping any more.
+    AssetPack::unmount();
+    PixelCache::logStats();
 
     IMG_Quit();
     SDL_Quit();
@@ -466,17 +939,24 @@ bool Game::isRunning() const
 
 void Game::spawnEnemies(SDL_Renderer *renderer)
 {
+    if (stressPopulation)
+    {
+        spawnStressPopulation(renderer);
+        return;
+    }
+
     // For testing: spawn two enemies at fixed positions.
     enemies.push_back(std::make_unique<Enemy>(400, 500, renderer));
     enemies.push_back(std::make_unique<Enemy>(200, 190, renderer));
     enemies.push_back(std::make_unique<Enemy>(950, 250, renderer));
     enemies.push_back(std::make_unique<BossEnemy>(1000, 325, renderer));
+    aliveEnemies = static_cast<int>(enemies.size());
 }
 
-void Game::renderEnemies(SDL_Renderer *renderer, int cameraX, int cameraY)
+void Game::renderEnemies(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha)
 {
     for (auto &enemy : enemies)
     {
-        enemy->render(renderer, cameraX, cameraY);
+        enemy->render(renderer, cameraX, cameraY, alpha);
     }
 }
@@ -1,34 +1,60 @@
 #include "InputManager.h"
 #include "Constants.h"
 
-void InputManager::processInput(const Uint8 *keys, float &velX, float &velY, bool &isMoving)
+void InputManager::sampleHeld(InputCommand &command, int cameraX, int cameraY)
 {
-    // Reset movement values.
-    velX = 0.0f;
-    velY = 0.0f;
-    isMoving = false;
+    const Uint8 *keys = SDL_GetKeyboardState(nullptr);
 
-    // Process horizontal input.
+    // Right and down win when both keys of an axis are held.
+    command.moveX = 0;
     if (keys[SDL_SCANCODE_RIGHT] || keys[SDL_SCANCODE_D])
-    {
-        velX = PLAYER_SPEED; // Use your player's speed or a defined constant.
-        isMoving = true;
-    }
+        command.moveX = 1;
     else if (keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A])
-    {
-        velX = -PLAYER_SPEED;
-        isMoving = true;
-    }
+        command.moveX = -1;
 
-    // Process vertical input.
+    command.moveY = 0;
     if (keys[SDL_SCANCODE_DOWN] || keys[SDL_SCANCODE_S])
-    {
-        velY = PLAYER_SPEED;
-        isMoving = true;
-    }
+        command.moveY = 1;
     else if (keys[SDL_SCANCODE_UP] || keys[SDL_SCANCODE_W])
+        command.moveY = -1;
+
+    int mouseX, mouseY;
+    SDL_GetMouseState(&mouseX, &mouseY);
+    command.aimX = static_cast<float>(mouseX + cameraX);
+    command.aimY = static_cast<float>(mouseY + cameraY);
+}
+
+bool InputManager::recordPress(InputCommand &command, const SDL_Event &event, int cameraX, int cameraY)
+{
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_r && !event.key.repeat)
     {
-        velY = -PLAYER_SPEED;
-        isMoving = true;
+        InputPress press;
+        press.timestamp = event.key.timestamp;
+        command.setPressed(InputAction::RESTART, press);
+        return true;
     }
+    if (event.type != SDL_MOUSEBUTTONDOWN)
+        return false;
+
+    InputAction action;
+    if (event.button.button == SDL_BUTTON_LEFT)
+        action = InputAction::FIRE;
+    else if (event.button.button == SDL_BUTTON_RIGHT)
+        action = InputAction::USE;
+    else
+        return false;
+
+    InputPress press;
+    press.x = static_cast<float>(event.button.x + cameraX);
+    press.y = static_cast<float>(event.button.y + cameraY);
+    press.timestamp = event.button.timestamp;
+    command.setPressed(action, press);
+    return true;
+}
+
+void InputManager::processInput(const InputCommand &command, float &velX, float &velY, bool &isMoving)
+{
+    velX = command.moveX * PLAYER_SPEED;
+    velY = command.moveY * PLAYER_SPEED;
+    isMoving = command.moveX != 0 || command.moveY != 0;
 }
@@ -1,262 +1,231 @@
 #include "Level.h"
-#include "MathUtils.h" // Use our dedicated math utility.
-#include <fstream>
-#include <iostream>
-#include <SDL2/SDL_image.h>
-#include <cmath>
+#include "Profiler.h"
+#include "Constants.h"
+#include "RenderStats.h"
+#include <algorithm>
 
-Level::Level(SDL_Renderer *renderer, const std::string &filename) : renderer(renderer)
+Level::Level(const std::string &filename)
 {
-    loadFromFile(filename);
+    PROFILE_SCOPE("Level::load");
+    LevelFormat::load(filename, data); // Failures are logged by LevelFormat.
+
+    if (data.infinite)
+    {
+        // Tiles are drawn up and to the right of their cell, rotated ones by up
+        // to their width plus height, so baked chunks get that much padding.
+        for (const auto &tileset : data.tilesets)
+            bakeMargin = std::max(bakeMargin, tileset.tileWidth + tileset.tileHeight);
+        streamer = std::make_unique<ChunkStreamer>(data, CHUNK_LOAD_MARGIN, CHUNK_EVICT_MARGIN);
+    }
+}
+
+Level::Level(SDL_Renderer *renderer, const std::string &filename) : Level(filename)
+{
+    loadTextures(renderer);
 }
 
 Level::~Level()
 {
-    // Smart pointers clean up textures automatically.
+    // TextureRefs release their references automatically.
 }
 
-void Level::loadFromFile(const std::string &filename)
+void Level::loadTextures(SDL_Renderer *renderer)
 {
-    std::ifstream file(filename);
-    if (!file)
-    {
-        std::cerr << "Failed to open level file: " << filename << std::endl;
-        return;
-    }
+    // Tileset images go through the shared texture cache, so images used by
+    // several maps (walls, doors, windows) are decoded only once. Queue every
+    // image first so they decode in parallel; each acquire then only waits
+    // for its own image.
+    for (const auto &tileset : data.tilesets)
+        ResourceManager::prefetchTexture(tileset.imagePath);
+
+    tilesetTextures.clear();
+    for (const auto &tileset : data.tilesets)
+        tilesetTextures.emplace_back(renderer, tileset.imagePath); // Failures are logged by ResourceManager.
+}
 
-    json levelData;
-    file >> levelData;
+std::vector<std::string> Level::getTilesetImages() const
+{
+    std::vector<std::string> images;
+    for (const auto &tileset : data.tilesets)
+        images.push_back(tileset.imagePath);
+    return images;
+}
 
-    int defaultTileWidth = levelData["tilewidth"];
-    int defaultTileHeight = levelData["tileheight"];
+size_t Level::getMemoryFootprint() const
+{
+    return data.getMemoryFootprint() + (streamer ? streamer->getMemoryUsage() : 0);
+}
 
-    // Load tilesets.
-    for (const auto &tilesetJson : levelData["tilesets"])
-    {
-        if (!loadTileset(tilesetJson))
-        {
-            // Error already logged.
-        }
-    }
+void Level::update(const SDL_Rect &view)
+{
+    if (!streamer || !streamer->update(view))
+        return;
 
-    // Load tile layers.
-    for (const auto &layer : levelData["layers"])
+    // Walls are only known for resident chunks; rebuild the grid from them.
+    std::vector<SDL_Rect> walls;
+    for (const auto &entry : streamer->getResidentChunks())
     {
-        if (layer["type"] == "tilelayer")
-        {
-            // Use the new function to encapsulate layer data.
-            TileLayer tileLayer = loadTileLayer(layer, defaultTileWidth, defaultTileHeight);
-            tileLayers.push_back(tileLayer);
-
-            // If the layer represents collision (e.g., walls/windows), generate collision tiles.
-            std::string layerName = layer["name"].get<std::string>();
-            if (layerName.find("wall") != std::string::npos || layerName == "window")
-            {
-                generateCollisionTilesForLayer(tileLayer, defaultTileWidth, defaultTileHeight);
-            }
-        }
+        const auto &rects = entry.second->chunk.collisionRects;
+        walls.insert(walls.end(), rects.begin(), rects.end());
     }
+    data.collision.build(std::move(walls));
 }
 
-bool Level::loadTileset(const json &tilesetJson)
+SDL_Rect Level::getBounds() const
 {
-    std::string imagePath = "assets/map/" + tilesetJson["image"].get<std::string>();
-    SDL_Surface *surface = IMG_Load(imagePath.c_str());
-    if (!surface)
+    if (data.infinite)
     {
-        std::cerr << "Failed to load surface: " << SDL_GetError() << std::endl;
-        return false;
+        if (data.chunks.empty())
+            return {0, 0, 0, 0};
+        int left = data.chunks.front().x, right = left;
+        int top = data.chunks.front().y, bottom = top;
+        for (const auto &chunk : data.chunks)
+        {
+            left = std::min(left, chunk.x);
+            right = std::max(right, chunk.x);
+            top = std::min(top, chunk.y);
+            bottom = std::max(bottom, chunk.y);
+        }
+        int chunkWidth = data.chunkSize * data.tileWidth;
+        int chunkHeight = data.chunkSize * data.tileHeight;
+        return {left * chunkWidth, top * chunkHeight, (right - left + 1) * chunkWidth, (bottom - top + 1) * chunkHeight};
     }
 
-    SDL_Texture *rawTexture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-
-    if (!rawTexture)
+    int width = 0, height = 0;
+    for (const auto &layer : data.layers)
     {
-        std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
-        return false;
+        width = std::max(width, layer.width);
+        height = std::max(height, layer.height);
     }
-
-    Tileset tileset;
-    tileset.firstGid = tilesetJson["firstgid"];
-    tileset.texture.reset(rawTexture);
-    tileset.tileWidth = tilesetJson["tilewidth"];
-    tileset.tileHeight = tilesetJson["tileheight"];
-    tileset.columns = tilesetJson["columns"];
-
-    tilesets.push_back(std::move(tileset));
-    return true;
+    return {0, 0, width * data.tileWidth, height * data.tileHeight};
 }
 
-Tileset *Level::getTilesetForTileID(int tileID)
+void Level::render(SDL_Renderer *renderer, int cameraX, int cameraY)
 {
-    for (auto it = tilesets.rbegin(); it != tilesets.rend(); ++it)
+    PROFILE_SCOPE("Level::render");
+    if (!streamer)
     {
-        if (tileID >= it->firstGid)
-            return &(*it);
+        for (const auto &layer : data.layers)
+            drawLayer(renderer, layer, -cameraX, -cameraY);
+        return;
     }
-    return nullptr;
-}
 
-TileLayer Level::loadTileLayer(const json &layerJson, int defaultTileWidth, int defaultTileHeight)
-{
-    TileLayer layer;
-    layer.name = layerJson["name"].get<std::string>();
-    layer.width = layerJson["width"];
-    layer.height = layerJson["height"];
-
-    // Initialize 2D vectors.
-    layer.tiles.resize(layer.height, std::vector<int>(layer.width, 0));
-    layer.flipFlags.resize(layer.height, std::vector<SDL_RendererFlip>(layer.width, SDL_FLIP_NONE));
-    layer.rotationAngles.resize(layer.height, std::vector<double>(layer.width, 0.0));
-
-    auto &data = layerJson["data"];
-    const int FLIP_MASK = 0x1FFFFFFF;
-
-    for (size_t i = 0; i < data.size(); i++)
+    const int chunkWidth = data.chunkSize * data.tileWidth;
+    const int chunkHeight = data.chunkSize * data.tileHeight;
+    // Cull against what the renderer actually outputs, which benchmarks and
+    // the golden check size freely.
+    int viewWidth = SCREEN_WIDTH, viewHeight = SCREEN_HEIGHT;
+    if (SDL_GetRendererOutputSize(renderer, &viewWidth, &viewHeight) != 0)
     {
-        int x = i % layer.width;
-        int y = i / layer.width;
-        int rawTileID = data[i].get<int>();
-        int tileID = rawTileID & FLIP_MASK;
-
-        bool flipHorizontal = (rawTileID & 0x80000000) != 0;
-        bool flipVertical = (rawTileID & 0x40000000) != 0;
-        bool flipDiagonal = (rawTileID & 0x20000000) != 0;
-
-        layer.tiles[y][x] = tileID;
+        viewWidth = SCREEN_WIDTH;
+        viewHeight = SCREEN_HEIGHT;
+    }
+    SDL_Rect screen = {-bakeMargin, -bakeMargin, viewWidth + 2 * bakeMargin, viewHeight + 2 * bakeMargin};
+    int baked = 0;
 
-        SDL_RendererFlip flipState = SDL_FLIP_NONE;
-        double rotation = 0.0;
+    for (const auto &entry : streamer->getResidentChunks())
+    {
+        ChunkStreamer::ResidentChunk &chunk = *entry.second;
+        int originX = chunk.chunk.x * chunkWidth - cameraX;
+        int originY = chunk.chunk.y * chunkHeight - cameraY;
+        SDL_Rect bounds = {originX, originY, chunkWidth, chunkHeight};
+        if (!SDL_HasIntersection(&bounds, &screen))
+            continue;
+
+        if (!chunk.baked && !chunk.bakeFailed && baked < CHUNK_BAKES_PER_FRAME)
+        {
+            bakeChunk(renderer, chunk);
+            baked++;
+        }
 
-        if (flipDiagonal)
+        if (chunk.baked)
         {
-            if (flipHorizontal && flipVertical)
-            {
-                rotation = 90.0;
-                flipState = SDL_FLIP_HORIZONTAL;
-            }
-            else if (flipHorizontal)
-            {
-                rotation = 270.0;
-                flipState = static_cast<SDL_RendererFlip>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
-            }
-            else if (flipVertical)
-            {
-                rotation = 90.0;
-                flipState = static_cast<SDL_RendererFlip>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
-            }
-            else
-            {
-                rotation = 90.0;
-                flipState = SDL_FLIP_VERTICAL;
-            }
+            SDL_Rect dest = {originX - bakeMargin, originY - bakeMargin, chunkWidth + 2 * bakeMargin, chunkHeight + 2 * bakeMargin};
+            RenderStats::copy(renderer, chunk.baked, nullptr, &dest);
         }
         else
         {
-            rotation = 0.0;
-            if (flipHorizontal)
-                flipState = SDL_FLIP_HORIZONTAL;
-            if (flipVertical)
-                flipState = static_cast<SDL_RendererFlip>(flipState | SDL_FLIP_VERTICAL);
+            for (const auto &layer : chunk.chunk.layers)
+                drawLayer(renderer, layer, originX, originY);
         }
-
-        layer.flipFlags[y][x] = flipState;
-        layer.rotationAngles[y][x] = rotation;
     }
-
-    return layer;
 }
 
-void Level::generateCollisionTilesForLayer(const TileLayer &layer, int defaultTileWidth, int defaultTileHeight)
+void Level::bakeChunk(SDL_Renderer *renderer, ChunkStreamer::ResidentChunk &chunk)
 {
-    // For each tile in the layer, if the tile is non-zero, generate a collision rectangle.
-    for (int y = 0; y < layer.height; y++)
+    PROFILE_SCOPE("Level::bakeChunk");
+    // Wait until every tileset is drawable, or the bake would miss tiles.
+    for (const auto &texture : tilesetTextures)
     {
-        for (int x = 0; x < layer.width; x++)
-        {
-            int tileID = layer.tiles[y][x];
-            if (tileID == 0)
-                continue;
-
-            Tileset *tileset = getTilesetForTileID(tileID);
-            if (!tileset)
-                continue;
-
-            int tileW = tileset->tileWidth;
-            int tileH = tileset->tileHeight;
-            int adjustedX = x * defaultTileWidth;
-            int adjustedY = (y + 1) * defaultTileHeight - tileH;
-            SDL_Point pivot = {0, tileH};
+        if (!texture)
+            return;
+    }
 
-            double rotation = layer.rotationAngles[y][x];
-            SDL_RendererFlip flipState = layer.flipFlags[y][x];
+    int width = data.chunkSize * data.tileWidth + 2 * bakeMargin;
+    int height = data.chunkSize * data.tileHeight + 2 * bakeMargin;
+    chunk.baked = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!chunk.baked)
+    {
+        // No render-target support: keep drawing this chunk tile by tile.
+        chunk.bakeFailed = true;
+        return;
+    }
+    SDL_SetTextureBlendMode(chunk.baked, SDL_BLENDMODE_BLEND);
 
-            if (rotation == 270.0)
-            {
-                adjustedX += tileH;
-            }
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
 
-            if (rotation == 90.0)
-            {
-                adjustedY -= tileW;
-            }
+    SDL_SetRenderTarget(renderer, chunk.baked);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    for (const auto &layer : chunk.chunk.layers)
+        drawLayer(renderer, layer, bakeMargin, bakeMargin);
 
-            // Use our dedicated math utility for transformed rect.
-            SDL_Rect collisionRect = computeTransformedRect(adjustedX, adjustedY, tileW, tileH, rotation, pivot, flipState);
-            collisionTiles.push_back(collisionRect);
-        }
-    }
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
 }
 
-void Level::render(SDL_Renderer *renderer, int cameraX, int cameraY)
+void Level::drawLayer(SDL_Renderer *renderer, const TileLayer &layer, int originX, int originY)
 {
-    const int defaultTileWidth = 32;
-    const int defaultTileHeight = 32;
-
-    for (const auto &layer : tileLayers)
+    for (int y = 0; y < layer.height; y++)
     {
-        for (int y = 0; y < layer.height; y++)
+        for (int x = 0; x < layer.width; x++)
         {
-            for (int x = 0; x < layer.width; x++)
-            {
-                int tileID = layer.tiles[y][x];
-                if (tileID == 0)
-                    continue;
-
-                Tileset *tileset = getTilesetForTileID(tileID);
-                if (!tileset)
-                    continue;
+            size_t index = static_cast<size_t>(y) * layer.width + x;
+            std::uint32_t tileID = layer.tiles[index];
+            std::uint16_t tilesetIndex = layer.tilesetIndex[index];
+            if (tileID == 0 || tilesetIndex == NO_TILESET)
+                continue;
 
-                int tilesPerRow = tileset->columns;
-                int localID = tileID - tileset->firstGid;
-                if (localID < 0)
-                    continue;
+            const TilesetInfo &tileset = data.tilesets[tilesetIndex];
+            int tilesPerRow = tileset.columns;
+            int localID = static_cast<int>(tileID) - tileset.firstGid;
 
-                SDL_Rect srcRect = {
-                    (localID % tilesPerRow) * tileset->tileWidth,
-                    (localID / tilesPerRow) * tileset->tileHeight,
-                    tileset->tileWidth,
-                    tileset->tileHeight};
+            SDL_Rect srcRect = {
+                (localID % tilesPerRow) * tileset.tileWidth,
+                (localID / tilesPerRow) * tileset.tileHeight,
+                tileset.tileWidth,
+                tileset.tileHeight};
 
-                SDL_RendererFlip flipState = layer.flipFlags[y][x];
-                double rotation = layer.rotationAngles[y][x];
+            SDL_RendererFlip flipState = tileFlip(layer.transforms[index]);
+            double rotation = tileRotation(layer.transforms[index]);
 
-                int tileW = tileset->tileWidth;
-                int tileH = tileset->tileHeight;
-                int adjustedX = x * defaultTileWidth - cameraX;
-                int adjustedY = y * defaultTileHeight - tileH - cameraY;
+            int tileW = tileset.tileWidth;
+            int tileH = tileset.tileHeight;
+            int adjustedX = originX + x * data.tileWidth;
+            int adjustedY = originY + y * data.tileHeight - tileH;
 
-                if (rotation == 270.0)
-                    adjustedX += tileH;
-                if (rotation == 90.0)
-                    adjustedY -= tileW;
+            if (rotation == 270.0)
+                adjustedX += tileH;
+            if (rotation == 90.0)
+                adjustedY -= tileW;
 
-                SDL_Rect destRect = {adjustedX, adjustedY, tileW, tileH};
-                SDL_Point pivot = {0, tileH};
+            SDL_Rect destRect = {adjustedX, adjustedY, tileW, tileH};
+            SDL_Point pivot = {0, tileH};
 
-                SDL_RenderCopyEx(renderer, tileset->texture.get(), &srcRect, &destRect, rotation, &pivot, flipState);
-            }
+            SDL_Texture *texture = tilesetIndex < tilesetTextures.size() ? tilesetTextures[tilesetIndex].get() : nullptr;
+            RenderStats::copyEx(renderer, texture, &srcRect, &destRect, rotation, &pivot, flipState);
         }
     }
 }
@@ -0,0 +1,873 @@
+#include "LevelFormat.h"
+#include "AssetPack.h"
+#include "Constants.h"
+#include "Hash.h"
+#include "MathUtils.h"
+#include "json.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <zlib.h>
+#ifdef LEVEL_ZSTD
+#include <zstd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace
+{
+    const char COOKED_MAGIC[4] = {'S', 'S', 'L', 'V'};
+
+    // Fixed-size prefix of a cooked level. Everything is stored in host
+    // (little-endian) byte order.
+    struct CookedHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t sourceHash;  // Of the JSON the level was cooked from.
+        std::uint64_t payloadHash; // Of every byte after the header.
+        std::int32_t tileWidth, tileHeight;
+        std::uint32_t tilesetCount, layerCount;
+        std::uint32_t chunkSize, chunkCount; // Both 0 for finite maps.
+    };
+
+    class BlobWriter
+    {
+    public:
+        template <typename T>
+        void put(const T &value)
+        {
+            const char *raw = reinterpret_cast<const char *>(&value);
+            bytes.insert(bytes.end(), raw, raw + sizeof(T));
+        }
+
+        template <typename T>
+        void putArray(const std::vector<T> &values)
+        {
+            const char *raw = reinterpret_cast<const char *>(values.data());
+            bytes.insert(bytes.end(), raw, raw + values.size() * sizeof(T));
+        }
+
+        void putString(const std::string &value)
+        {
+            put(static_cast<std::uint32_t>(value.size()));
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+
+        std::vector<char> bytes;
+    };
+
+    // Bounds-checked cursor over a cooked blob.
+    class BlobReader
+    {
+    public:
+        explicit BlobReader(const std::vector<char> &bytes) : bytes(bytes) {}
+
+        template <typename T>
+        bool get(T &value)
+        {
+            if (bytes.size() - pos < sizeof(T))
+                return false;
+            std::memcpy(&value, bytes.data() + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool getArray(std::vector<T> &values, size_t count)
+        {
+            if (count > (bytes.size() - pos) / sizeof(T))
+                return false;
+            values.resize(count);
+            if (count > 0)
+                std::memcpy(values.data(), bytes.data() + pos, count * sizeof(T));
+            pos += count * sizeof(T);
+            return true;
+        }
+
+        bool getString(std::string &value)
+        {
+            std::uint32_t length;
+            if (!get(length) || bytes.size() - pos < length)
+                return false;
+            value.assign(bytes.data() + pos, length);
+            pos += length;
+            return true;
+        }
+
+        bool atEnd() const { return pos == bytes.size(); }
+        size_t remaining() const { return bytes.size() - pos; }
+
+    private:
+        const std::vector<char> &bytes;
+        size_t pos = 0;
+    };
+
+    // Decodes Tiled's flip bits into our per-tile transform byte.
+    std::uint8_t decodeTransform(std::uint32_t rawTileID)
+    {
+        bool flipHorizontal = (rawTileID & 0x80000000) != 0;
+        bool flipVertical = (rawTileID & 0x40000000) != 0;
+        bool flipDiagonal = (rawTileID & 0x20000000) != 0;
+
+        if (flipDiagonal)
+        {
+            if (flipHorizontal && flipVertical)
+                return TILE_ROTATE_90 | SDL_FLIP_HORIZONTAL;
+            if (flipHorizontal)
+                return TILE_ROTATE_270 | SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL;
+            if (flipVertical)
+                return TILE_ROTATE_90 | SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL;
+            return TILE_ROTATE_90 | SDL_FLIP_VERTICAL;
+        }
+
+        std::uint8_t transform = 0;
+        if (flipHorizontal)
+            transform |= SDL_FLIP_HORIZONTAL;
+        if (flipVertical)
+            transform |= SDL_FLIP_VERTICAL;
+        return transform;
+    }
+
+    // Index of the tileset owning tileID: the last one whose firstGid <= tileID.
+    std::uint16_t findTileset(const std::vector<TilesetInfo> &tilesets, std::uint32_t tileID)
+    {
+        for (size_t i = tilesets.size(); i-- > 0;)
+        {
+            if (static_cast<int>(tileID) >= tilesets[i].firstGid)
+                return static_cast<std::uint16_t>(i);
+        }
+        return NO_TILESET;
+    }
+
+    // Splits the raw GIDs the parser stored in layer.tiles into tile IDs,
+    // transforms and tileset indices, once the tilesets are known.
+    void finishTileLayer(TileLayer &layer, const std::vector<TilesetInfo> &tilesets)
+    {
+        // If the layer represents collision (e.g., walls/windows), it generates collision tiles.
+        layer.collision = layer.name.find("wall") != std::string::npos || layer.name == "window";
+
+        size_t cells = static_cast<size_t>(layer.width) * layer.height;
+        layer.tiles.resize(cells, 0);
+        layer.transforms.assign(cells, 0);
+        layer.tilesetIndex.assign(cells, NO_TILESET);
+
+        const std::uint32_t FLIP_MASK = 0x1FFFFFFF;
+        for (size_t i = 0; i < cells; i++)
+        {
+            std::uint32_t rawTileID = layer.tiles[i];
+            std::uint32_t tileID = rawTileID & FLIP_MASK;
+            layer.tiles[i] = tileID;
+            layer.transforms[i] = decodeTransform(rawTileID);
+            if (tileID != 0)
+                layer.tilesetIndex[i] = findTileset(tilesets, tileID);
+        }
+    }
+
+    // Decodes base64 text into out. Whitespace is skipped; returns false on
+    // any other non-alphabet character.
+    bool decodeBase64(const std::string &text, std::vector<unsigned char> &out)
+    {
+        static const auto table = []
+        {
+            std::array<std::int8_t, 256> values;
+            values.fill(-1);
+            const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; i++)
+                values[static_cast<unsigned char>(alphabet[i])] = static_cast<std::int8_t>(i);
+            return values;
+        }();
+
+        out.clear();
+        out.reserve(text.size() / 4 * 3);
+        std::uint32_t bits = 0;
+        int bitCount = 0;
+        for (char c : text)
+        {
+            if (c == '=')
+                break;
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+                continue;
+            std::int8_t value = table[static_cast<unsigned char>(c)];
+            if (value < 0)
+                return false;
+            bits = (bits << 6) | static_cast<std::uint32_t>(value);
+            bitCount += 6;
+            if (bitCount >= 8)
+            {
+                bitCount -= 8;
+                out.push_back(static_cast<unsigned char>(bits >> bitCount));
+            }
+        }
+        return true;
+    }
+
+    // Decodes a base64 layer ("compression" empty, zlib, gzip or zstd) into
+    // layer.tiles as raw GIDs. Tiled stores them as little-endian uint32s,
+    // which is also the host order, so decompression writes straight into the
+    // tile buffer.
+    bool decodeLayerData(const std::string &encoded, const std::string &compression, TileLayer &layer)
+    {
+        std::vector<unsigned char> bytes;
+        if (!decodeBase64(encoded, bytes))
+        {
+            std::cerr << "Invalid base64 data in layer " << layer.name << std::endl;
+            return false;
+        }
+
+        size_t cells = static_cast<size_t>(layer.width) * layer.height;
+        size_t expected = cells * sizeof(std::uint32_t);
+        layer.tiles.assign(cells, 0);
+        size_t decoded = 0;
+
+        if (compression.empty())
+        {
+            decoded = bytes.size();
+            std::memcpy(layer.tiles.data(), bytes.data(), std::min(decoded, expected));
+        }
+        else if (compression == "zlib" || compression == "gzip")
+        {
+            z_stream stream = {};
+            if (inflateInit2(&stream, 15 + 32) != Z_OK) // +32: accept zlib or gzip headers.
+                return false;
+            stream.next_in = bytes.data();
+            stream.avail_in = static_cast<uInt>(bytes.size());
+            stream.next_out = reinterpret_cast<Bytef *>(layer.tiles.data());
+            stream.avail_out = static_cast<uInt>(expected);
+            int status = inflate(&stream, Z_FINISH);
+            decoded = stream.total_out;
+            inflateEnd(&stream);
+            if (status != Z_STREAM_END)
+            {
+                std::cerr << "Corrupt " << compression << " data in layer " << layer.name << std::endl;
+                return false;
+            }
+        }
+        else if (compression == "zstd")
+        {
+#ifdef LEVEL_ZSTD
+            size_t result = ZSTD_decompress(layer.tiles.data(), expected, bytes.data(), bytes.size());
+            if (ZSTD_isError(result))
+            {
+                std::cerr << "Corrupt zstd data in layer " << layer.name << ": " << ZSTD_getErrorName(result) << std::endl;
+                return false;
+            }
+            decoded = result;
+#else
+            std::cerr << "Layer " << layer.name << " uses zstd; rebuild with ZSTD=1 to load it" << std::endl;
+            return false;
+#endif
+        }
+        else
+        {
+            std::cerr << "Unsupported layer compression: " << compression << std::endl;
+            return false;
+        }
+
+        if (decoded != expected)
+        {
+            std::cerr << "Layer " << layer.name << " holds " << decoded / 4 << " of " << cells << " tiles" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // A chunk of an infinite layer as read from JSON: position in tiles and
+    // raw GIDs in tiles.tiles (width/height/name set for decodeLayerData).
+    struct PendingChunk
+    {
+        int x = 0, y = 0;
+        TileLayer tiles;
+        std::string encodedData;
+    };
+
+    // Streams a Tiled map through nlohmann's SAX interface. Only the fields
+    // the game uses are kept, and layer GIDs are appended straight to the
+    // layer's tile array, so no JSON DOM is ever built.
+    class TiledSaxHandler : public nlohmann::json_sax<json>
+    {
+    public:
+        explicit TiledSaxHandler(LevelData &out) : out(out) {}
+
+        // Chunks of each layer in out.layers (empty for finite layers).
+        std::vector<std::vector<PendingChunk>> layerChunks;
+
+        bool null() override { return true; }
+        bool boolean(bool val) override
+        {
+            if (top() == Context::ROOT && currentKey == "infinite")
+                out.infinite = val;
+            return true;
+        }
+        bool number_integer(number_integer_t val) override { return number(val); }
+        bool number_unsigned(number_unsigned_t val) override { return number(static_cast<std::int64_t>(val)); }
+        bool number_float(number_float_t val, const string_t &) override { return number(static_cast<std::int64_t>(val)); }
+        bool binary(binary_t &) override { return true; }
+
+        bool string(string_t &val) override
+        {
+            if (top() == Context::TILESET && currentKey == "image")
+                out.tilesets.back().imagePath = "assets/map/" + val;
+            else if (top() == Context::LAYER && currentKey == "name")
+                layer.name = val;
+            else if (top() == Context::LAYER && currentKey == "type")
+                layerType = val;
+            else if (top() == Context::LAYER && currentKey == "data")
+                encodedData = std::move(val); // Base64; decoded once encoding and size are known.
+            else if (top() == Context::LAYER && currentKey == "encoding")
+                encoding = val;
+            else if (top() == Context::LAYER && currentKey == "compression")
+                compression = val;
+            else if (top() == Context::CHUNK && currentKey == "data")
+                chunk.encodedData = std::move(val);
+            return true;
+        }
+
+        bool start_object(std::size_t) override
+        {
+            Context parent = top();
+            if (stack.empty())
+                stack.push_back(Context::ROOT);
+            else if (parent == Context::TILESETS)
+            {
+                out.tilesets.push_back({0, "", 0, 0, 0});
+                stack.push_back(Context::TILESET);
+            }
+            else if (parent == Context::LAYERS)
+            {
+                layer = TileLayer();
+                layer.tiles.reserve(lastLayerCells);
+                layerType.clear();
+                encoding.clear();
+                compression.clear();
+                encodedData.clear();
+                chunks.clear();
+                stack.push_back(Context::LAYER);
+            }
+            else if (parent == Context::CHUNKS)
+            {
+                chunk = PendingChunk();
+                stack.push_back(Context::CHUNK);
+            }
+            else
+                stack.push_back(Context::OTHER);
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if (top() == Context::LAYER && layerType == "tilelayer")
+            {
+                // Infinite maps keep their data in the chunks instead.
+                if (encoding == "base64" && chunks.empty() && !decodeLayerData(encodedData, compression, layer))
+                    return false;
+                for (auto &pending : chunks)
+                {
+                    pending.tiles.name = layer.name;
+                    if (encoding == "base64" && !decodeLayerData(pending.encodedData, compression, pending.tiles))
+                        return false;
+                    pending.encodedData.clear();
+                }
+                lastLayerCells = layer.tiles.size();
+                out.layers.push_back(std::move(layer));
+                layerChunks.push_back(std::move(chunks));
+            }
+            else if (top() == Context::CHUNK)
+                chunks.push_back(std::move(chunk));
+            stack.pop_back();
+            return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+            Context parent = top();
+            if (parent == Context::ROOT && currentKey == "layers")
+                stack.push_back(Context::LAYERS);
+            else if (parent == Context::ROOT && currentKey == "tilesets")
+                stack.push_back(Context::TILESETS);
+            else if (parent == Context::LAYER && currentKey == "data")
+                stack.push_back(Context::LAYER_DATA);
+            else if (parent == Context::LAYER && currentKey == "chunks")
+                stack.push_back(Context::CHUNKS);
+            else if (parent == Context::CHUNK && currentKey == "data")
+                stack.push_back(Context::CHUNK_DATA);
+            else
+                stack.push_back(Context::OTHER);
+            return true;
+        }
+
+        bool end_array() override
+        {
+            stack.pop_back();
+            return true;
+        }
+
+        bool key(string_t &val) override
+        {
+            currentKey = val;
+            return true;
+        }
+
+        bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception &ex) override
+        {
+            std::cerr << "Failed to parse level JSON at byte " << position << ": " << ex.what() << std::endl;
+            return false;
+        }
+
+    private:
+        enum class Context
+        {
+            ROOT,
+            TILESETS,
+            TILESET,
+            LAYERS,
+            LAYER,
+            LAYER_DATA,
+            CHUNKS,
+            CHUNK,
+            CHUNK_DATA,
+            OTHER
+        };
+
+        Context top() const { return stack.empty() ? Context::OTHER : stack.back(); }
+
+        bool number(std::int64_t val)
+        {
+            int value = static_cast<int>(val);
+            switch (top())
+            {
+            case Context::LAYER_DATA:
+                layer.tiles.push_back(static_cast<std::uint32_t>(val)); // Raw GID, flip bits included.
+                break;
+            case Context::ROOT:
+                if (currentKey == "tilewidth")
+                    out.tileWidth = value;
+                else if (currentKey == "tileheight")
+                    out.tileHeight = value;
+                break;
+            case Context::TILESET:
+            {
+                TilesetInfo &tileset = out.tilesets.back();
+                if (currentKey == "firstgid")
+                    tileset.firstGid = value;
+                else if (currentKey == "tilewidth")
+                    tileset.tileWidth = value;
+                else if (currentKey == "tileheight")
+                    tileset.tileHeight = value;
+                else if (currentKey == "columns")
+                    tileset.columns = value;
+                break;
+            }
+            case Context::LAYER:
+                if (currentKey == "width")
+                    layer.width = value;
+                else if (currentKey == "height")
+                    layer.height = value;
+                break;
+            case Context::CHUNK_DATA:
+                chunk.tiles.tiles.push_back(static_cast<std::uint32_t>(val));
+                break;
+            case Context::CHUNK:
+                if (currentKey == "x")
+                    chunk.x = value;
+                else if (currentKey == "y")
+                    chunk.y = value;
+                else if (currentKey == "width")
+                    chunk.tiles.width = value;
+                else if (currentKey == "height")
+                    chunk.tiles.height = value;
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
+
+        LevelData &out;
+        std::vector<Context> stack;
+        std::string currentKey; // Most recent object key.
+        TileLayer layer;       // Layer being parsed.
+        std::string layerType; // Its "type"; only tile layers are kept.
+        std::string encoding, compression, encodedData; // Set for base64 layers.
+        std::vector<PendingChunk> chunks; // Chunks of the layer being parsed.
+        PendingChunk chunk;               // Chunk being parsed.
+        size_t lastLayerCells = 0; // Layers usually share a size, so reserve the previous one's.
+    };
+
+    // originX/originY place the layer's first tile in the map, in tiles
+    // (non-zero for chunks of infinite maps).
+    void generateCollisionTilesForLayer(const TileLayer &layer, const LevelData &data, int originX, int originY,
+                                        std::vector<SDL_Rect> &out)
+    {
+        // For each tile in the layer, if the tile is non-zero, generate a collision rectangle.
+        for (int y = 0; y < layer.height; y++)
+        {
+            for (int x = 0; x < layer.width; x++)
+            {
+                size_t index = static_cast<size_t>(y) * layer.width + x;
+                if (layer.tiles[index] == 0 || layer.tilesetIndex[index] == NO_TILESET)
+                    continue;
+
+                const TilesetInfo &tileset = data.tilesets[layer.tilesetIndex[index]];
+                int tileW = tileset.tileWidth;
+                int tileH = tileset.tileHeight;
+                int adjustedX = (originX + x) * data.tileWidth;
+                int adjustedY = (originY + y + 1) * data.tileHeight - tileH;
+                SDL_Point pivot = {0, tileH};
+
+                double rotation = tileRotation(layer.transforms[index]);
+                SDL_RendererFlip flipState = tileFlip(layer.transforms[index]);
+
+                if (rotation == 270.0)
+                    adjustedX += tileH;
+                if (rotation == 90.0)
+                    adjustedY -= tileW;
+
+                // Use our dedicated math utility for transformed rect.
+                out.push_back(computeTransformedRect(adjustedX, adjustedY, tileW, tileH, rotation, pivot, flipState));
+            }
+        }
+    }
+
+    // a * b, or false when the product does not fit in a size_t.
+    bool multiplyChecked(size_t a, size_t b, size_t &product)
+    {
+        if (b != 0 && a > std::numeric_limits<size_t>::max() / b)
+            return false;
+        product = a * b;
+        return true;
+    }
+
+    // Floor division, so chunks left of or above the origin get negative coordinates.
+    int floorDiv(int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Merges the per-layer chunks of an infinite map into one record per
+    // chunk position, each holding every layer's GIDs back to back.
+    bool assembleChunks(LevelData &data, std::vector<std::vector<PendingChunk>> &layerChunks)
+    {
+        for (const auto &chunks : layerChunks)
+        {
+            for (const auto &chunk : chunks)
+            {
+                if (data.chunkSize == 0)
+                    data.chunkSize = chunk.tiles.width;
+                if (chunk.tiles.width != data.chunkSize || chunk.tiles.height != data.chunkSize || data.chunkSize <= 0 ||
+                    chunk.x % data.chunkSize != 0 || chunk.y % data.chunkSize != 0)
+                {
+                    std::cerr << "Infinite map chunks must be square, equally sized and aligned" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        size_t cells = static_cast<size_t>(data.chunkSize) * data.chunkSize;
+        size_t stride = cells * data.layers.size();
+        std::map<std::pair<int, int>, std::vector<std::uint32_t>> byPosition; // Keyed (y, x).
+        for (size_t layer = 0; layer < layerChunks.size(); layer++)
+        {
+            for (const auto &chunk : layerChunks[layer])
+            {
+                auto &tiles = byPosition[{floorDiv(chunk.y, data.chunkSize), floorDiv(chunk.x, data.chunkSize)}];
+                tiles.resize(stride, 0);
+                size_t count = std::min(chunk.tiles.tiles.size(), cells);
+                std::copy(chunk.tiles.tiles.begin(), chunk.tiles.tiles.begin() + count, tiles.begin() + layer * cells);
+            }
+        }
+
+        for (const auto &entry : byPosition)
+        {
+            data.chunks.push_back({entry.first.second, entry.first.first, data.chunkTiles.size()});
+            data.chunkTiles.insert(data.chunkTiles.end(), entry.second.begin(), entry.second.end());
+        }
+        return true;
+    }
+}
+
+const ChunkRecord *LevelData::findChunk(int x, int y) const
+{
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), std::make_pair(y, x),
+                               [](const ChunkRecord &record, const std::pair<int, int> &key)
+                               { return std::make_pair(record.y, record.x) < key; });
+    if (it == chunks.end() || it->x != x || it->y != y)
+        return nullptr;
+    return &*it;
+}
+
+size_t LevelData::getMemoryFootprint() const
+{
+    size_t bytes = collision.getMemoryFootprint() + chunks.capacity() * sizeof(ChunkRecord) +
+                   chunkTiles.capacity() * sizeof(std::uint32_t);
+    for (const auto &layer : layers)
+    {
+        bytes += layer.tiles.capacity() * sizeof(std::uint32_t) +
+                 layer.transforms.capacity() * sizeof(std::uint8_t) +
+                 layer.tilesetIndex.capacity() * sizeof(std::uint16_t);
+    }
+    return bytes;
+}
+
+bool LevelFormat::readFile(const std::string &path, std::vector<char> &out)
+{
+    return AssetPack::read(path, out);
+}
+
+std::string LevelFormat::cookedPathFor(const std::string &jsonPath)
+{
+    size_t dot = jsonPath.rfind('.');
+    return (dot == std::string::npos ? jsonPath : jsonPath.substr(0, dot)) + ".lvl";
+}
+
+bool LevelFormat::load(const std::string &jsonPath, LevelData &out)
+{
+    std::vector<char> source;
+    if (!readFile(jsonPath, source))
+    {
+        std::cerr << "Failed to open level file: " << jsonPath << std::endl;
+        return false;
+    }
+
+    // Use the cooked blob only if it was built from exactly this JSON.
+    std::vector<char> cooked;
+    std::uint64_t sourceHash = hashBytes(source.data(), source.size());
+    if (readFile(cookedPathFor(jsonPath), cooked) && readCooked(cooked, sourceHash, out))
+        return true;
+
+    return parseJson(source.data(), source.size(), out);
+}
+
+bool LevelFormat::parseJson(const char *text, size_t size, LevelData &out)
+{
+    LevelData data;
+    TiledSaxHandler handler(data);
+    if (!json::sax_parse(text, text + size, &handler))
+        return false;
+
+    // Infinite layers keep their tiles in chunks; their width/height is only
+    // Tiled's bounding box.
+    if (data.infinite)
+    {
+        for (auto &layer : data.layers)
+            layer.width = layer.height = 0;
+        if (!assembleChunks(data, handler.layerChunks))
+            return false;
+    }
+
+    // Tiled writes "layers" before "tilesets", so GIDs are resolved afterwards.
+    std::vector<SDL_Rect> collisionTiles;
+    for (auto &layer : data.layers)
+    {
+        finishTileLayer(layer, data.tilesets);
+        if (layer.collision)
+            generateCollisionTilesForLayer(layer, data, 0, 0, collisionTiles);
+    }
+    data.collision.build(std::move(collisionTiles));
+    out = std::move(data);
+    return true;
+}
+
+bool LevelFormat::readCooked(const std::vector<char> &blob, std::uint64_t sourceHash, LevelData &out)
+{
+    // Any failure below makes the caller fall back to the JSON, so a stale,
+    // truncated or corrupt blob must be rejected before anything is sized or
+    // indexed from it.
+    BlobReader reader(blob);
+    CookedHeader header;
+    if (!reader.get(header) || std::memcmp(header.magic, COOKED_MAGIC, 4) != 0 ||
+        header.version != COOKED_VERSION || header.sourceHash != sourceHash ||
+        header.payloadHash != hashBytes(blob.data() + sizeof(CookedHeader), blob.size() - sizeof(CookedHeader)))
+        return false;
+
+    LevelData data;
+    data.tileWidth = header.tileWidth;
+    data.tileHeight = header.tileHeight;
+
+    // Every tileset and layer takes at least this many bytes, which bounds
+    // their counts by what is left of the blob.
+    const size_t MIN_TILESET_BYTES = 4 * sizeof(std::int32_t) + sizeof(std::uint32_t);
+    const size_t MIN_LAYER_BYTES = sizeof(std::uint32_t) + 2 * sizeof(std::int32_t) + sizeof(std::uint8_t);
+    if (header.tilesetCount > reader.remaining() / MIN_TILESET_BYTES)
+        return false;
+    data.tilesets.resize(header.tilesetCount);
+    for (auto &tileset : data.tilesets)
+    {
+        std::int32_t fields[4];
+        if (!reader.get(fields) || !reader.getString(tileset.imagePath))
+            return false;
+        tileset.firstGid = fields[0];
+        tileset.tileWidth = fields[1];
+        tileset.tileHeight = fields[2];
+        tileset.columns = fields[3];
+        if (tileset.columns <= 0) // Level::render divides by it.
+            return false;
+    }
+
+    if (header.layerCount > reader.remaining() / MIN_LAYER_BYTES)
+        return false;
+    data.layers.resize(header.layerCount);
+    for (auto &layer : data.layers)
+    {
+        std::int32_t size[2];
+        std::uint8_t collision;
+        if (!reader.getString(layer.name) || !reader.get(size) || !reader.get(collision) || size[0] < 0 || size[1] < 0)
+            return false;
+        layer.width = size[0];
+        layer.height = size[1];
+        layer.collision = collision != 0;
+        size_t cells = static_cast<size_t>(layer.width) * layer.height;
+        if (!reader.getArray(layer.tiles, cells) || !reader.getArray(layer.transforms, cells) ||
+            !reader.getArray(layer.tilesetIndex, cells))
+            return false;
+        for (std::uint16_t tileset : layer.tilesetIndex)
+        {
+            if (tileset >= header.tilesetCount && tileset != NO_TILESET)
+                return false;
+        }
+    }
+
+    CollisionGrid &grid = data.collision;
+    std::int32_t gridFields[5];
+    std::uint32_t rectCount, itemCount;
+    if (!reader.get(gridFields) || !reader.get(rectCount) || !reader.get(itemCount))
+        return false;
+    grid.cellSize = gridFields[0];
+    grid.originX = gridFields[1];
+    grid.originY = gridFields[2];
+    grid.columns = gridFields[3];
+    grid.rows = gridFields[4];
+    if (grid.columns < 0 || grid.rows < 0 || (grid.columns > 0 && grid.cellSize <= 0))
+        return false;
+    size_t cellCount = grid.columns > 0 ? static_cast<size_t>(grid.columns) * grid.rows + 1 : 0;
+    if (!reader.getArray(grid.rects, rectCount) || !reader.getArray(grid.cellStart, cellCount) ||
+        !reader.getArray(grid.cellItems, itemCount))
+        return false;
+    for (size_t i = 0; i < grid.cellStart.size(); i++)
+    {
+        if (grid.cellStart[i] > itemCount || (i > 0 && grid.cellStart[i] < grid.cellStart[i - 1]))
+            return false;
+    }
+    for (std::uint32_t item : grid.cellItems)
+    {
+        if (item >= rectCount)
+            return false;
+    }
+
+    if (header.chunkSize > static_cast<std::uint32_t>(std::numeric_limits<int>::max()))
+        return false;
+    data.infinite = header.chunkSize > 0;
+    data.chunkSize = static_cast<int>(header.chunkSize);
+    size_t cells, stride, chunkTileCount;
+    if (!multiplyChecked(header.chunkSize, header.chunkSize, cells) ||
+        !multiplyChecked(cells, header.layerCount, stride) ||
+        !multiplyChecked(stride, header.chunkCount, chunkTileCount))
+        return false;
+    if (!reader.getArray(data.chunks, header.chunkCount) || !reader.getArray(data.chunkTiles, chunkTileCount) ||
+        !reader.atEnd())
+        return false;
+
+    // Every chunk must hold all its layers inside chunkTiles, and findChunk
+    // needs the records sorted by (y, x).
+    for (size_t i = 0; i < data.chunks.size(); i++)
+    {
+        const ChunkRecord &record = data.chunks[i];
+        if (record.offset > data.chunkTiles.size() || data.chunkTiles.size() - record.offset < stride)
+            return false;
+        if (i > 0 && std::make_pair(data.chunks[i - 1].y, data.chunks[i - 1].x) >= std::make_pair(record.y, record.x))
+            return false;
+    }
+
+    out = std::move(data);
+    return true;
+}
+
+bool LevelFormat::writeCooked(const std::string &cookedPath, const LevelData &data, std::uint64_t sourceHash)
+{
+    BlobWriter writer;
+    CookedHeader header;
+    std::memcpy(header.magic, COOKED_MAGIC, 4);
+    header.version = COOKED_VERSION;
+    header.sourceHash = sourceHash;
+    header.payloadHash = 0;
+    header.tileWidth = data.tileWidth;
+    header.tileHeight = data.tileHeight;
+    header.tilesetCount = static_cast<std::uint32_t>(data.tilesets.size());
+    header.layerCount = static_cast<std::uint32_t>(data.layers.size());
+    header.chunkSize = static_cast<std::uint32_t>(data.chunkSize);
+    header.chunkCount = static_cast<std::uint32_t>(data.chunks.size());
+    writer.put(header);
+
+    for (const auto &tileset : data.tilesets)
+    {
+        std::int32_t fields[4] = {tileset.firstGid, tileset.tileWidth, tileset.tileHeight, tileset.columns};
+        writer.put(fields);
+        writer.putString(tileset.imagePath);
+    }
+
+    for (const auto &layer : data.layers)
+    {
+        std::int32_t size[2] = {layer.width, layer.height};
+        writer.putString(layer.name);
+        writer.put(size);
+        writer.put(static_cast<std::uint8_t>(layer.collision));
+        writer.putArray(layer.tiles);
+        writer.putArray(layer.transforms);
+        writer.putArray(layer.tilesetIndex);
+    }
+
+    const CollisionGrid &grid = data.collision;
+    std::int32_t gridFields[5] = {grid.cellSize, grid.originX, grid.originY, grid.columns, grid.rows};
+    writer.put(gridFields);
+    writer.put(static_cast<std::uint32_t>(grid.rects.size()));
+    writer.put(static_cast<std::uint32_t>(grid.cellItems.size()));
+    writer.putArray(grid.rects);
+    writer.putArray(grid.cellStart);
+    writer.putArray(grid.cellItems);
+    writer.putArray(data.chunks);
+    writer.putArray(data.chunkTiles);
+
+    // The header is written first, so its payload hash is patched in last.
+    header.payloadHash = hashBytes(writer.bytes.data() + sizeof(CookedHeader), writer.bytes.size() - sizeof(CookedHeader));
+    std::memcpy(writer.bytes.data(), &header, sizeof(CookedHeader));
+
+    std::ofstream file(cookedPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    return static_cast<bool>(file.write(writer.bytes.data(), static_cast<std::streamsize>(writer.bytes.size())));
+}
+
+void LevelFormat::loadChunk(const LevelData &data, const ChunkRecord &record, LevelChunk &out)
+{
+    size_t cells = static_cast<size_t>(data.chunkSize) * data.chunkSize;
+    out.x = record.x;
+    out.y = record.y;
+    out.layers.resize(data.layers.size());
+    out.collisionRects.clear();
+
+    for (size_t i = 0; i < data.layers.size(); i++)
+    {
+        TileLayer &layer = out.layers[i];
+        layer.name = data.layers[i].name;
+        layer.width = layer.height = data.chunkSize;
+        auto first = data.chunkTiles.begin() + static_cast<std::ptrdiff_t>(record.offset + i * cells);
+        layer.tiles.assign(first, first + static_cast<std::ptrdiff_t>(cells));
+        finishTileLayer(layer, data.tilesets);
+        if (layer.collision)
+            generateCollisionTilesForLayer(layer, data, record.x * data.chunkSize, record.y * data.chunkSize,
+                                           out.collisionRects);
+    }
+}
+
+bool LevelFormat::cook(const std::string &jsonPath, const std::string &cookedPath)
+{
+    std::vector<char> source;
+    LevelData data;
+    if (!readFile(jsonPath, source) || !parseJson(source.data(), source.size(), data))
+        return false;
+    return writeCooked(cookedPath, data, hashBytes(source.data(), source.size()));
+}
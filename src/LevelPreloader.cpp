@@ -0,0 +1,136 @@
+#include "LevelPreloader.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+LevelPreloader::LevelPreloader(int maxLevels, size_t memoryBudget)
+    : maxLevels(maxLevels), memoryBudget(memoryBudget)
+{
+}
+
+LevelPreloader::~LevelPreloader()
+{
+    clear();
+}
+
+bool LevelPreloader::request(int index, const std::string &filename)
+{
+    for (const auto &entry : entries)
+    {
+        if (entry.index == index)
+            return true;
+    }
+
+    if (static_cast<int>(entries.size()) >= maxLevels || getMemoryUsage() >= memoryBudget)
+        return false;
+
+    Entry entry;
+    entry.index = index;
+    entry.pending = std::async(std::launch::async, [filename]
+                               {
+                                   PROFILE_THREAD("level preloader");
+                                   return std::make_unique<Level>(filename); });
+    entries.push_back(std::move(entry));
+    return true;
+}
+
+void LevelPreloader::finishParse(Entry &entry)
+{
+    entry.level = entry.pending.get();
+
+    // Tileset textures are shared, so prefetching one that is already
+    // resident costs nothing. The preloader holds a reference to each until
+    // the level is taken.
+    for (const auto &image : entry.level->getTilesetImages())
+    {
+        TextureHandle handle = ResourceManager::prefetchTexture(image);
+        ResourceManager::addReference(handle);
+        entry.tilesetTextures.push_back(handle);
+    }
+}
+
+void LevelPreloader::poll()
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->pending.valid() &&
+            it->pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            finishParse(*it);
+            if (getMemoryUsage() > memoryBudget)
+            {
+                // Over budget: drop this level; it will be loaded on demand instead.
+                for (TextureHandle handle : it->tilesetTextures)
+                    ResourceManager::releaseTexture(handle);
+                it = entries.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+}
+
+bool LevelPreloader::isReady(int index) const
+{
+    for (const auto &entry : entries)
+    {
+        if (entry.index != index)
+            continue;
+        if (!entry.level)
+            return false;
+        return std::all_of(entry.tilesetTextures.begin(), entry.tilesetTextures.end(),
+                           [](TextureHandle handle)
+                           { return ResourceManager::isTextureReady(handle); });
+    }
+    return false;
+}
+
+std::unique_ptr<Level> LevelPreloader::take(int index, SDL_Renderer *renderer)
+{
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->index != index)
+            continue;
+
+        if (!it->level)
+            finishParse(*it);
+
+        // Textures that finished uploading are just looked up; any still
+        // decoding are waited for here.
+        std::unique_ptr<Level> level = std::move(it->level);
+        level->loadTextures(renderer);
+        for (TextureHandle handle : it->tilesetTextures)
+            ResourceManager::releaseTexture(handle);
+        entries.erase(it);
+        return level;
+    }
+    return nullptr;
+}
+
+void LevelPreloader::clear()
+{
+    for (auto &entry : entries)
+    {
+        if (entry.pending.valid())
+            entry.pending.wait();
+        for (TextureHandle handle : entry.tilesetTextures)
+            ResourceManager::releaseTexture(handle);
+    }
+    entries.clear();
+}
+
+size_t LevelPreloader::entryMemory(const Entry &entry) const
+{
+    size_t bytes = entry.level ? entry.level->getMemoryFootprint() : 0;
+    for (TextureHandle handle : entry.tilesetTextures)
+        bytes += ResourceManager::getTextureBytes(handle);
+    return bytes;
+}
+
+size_t LevelPreloader::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto &entry : entries)
+        bytes += entryMemory(entry);
+    return bytes;
+}
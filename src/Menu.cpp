@@ -1,16 +1,13 @@
 // Menu.cpp
 #include "Menu.h"
 #include "Constants.h"
+#include "RenderStats.h"
 
 Menu::Menu(SDL_Renderer *renderer, bool pause) : renderer(renderer), isPause(pause)
 {
     if (!isPause)
     {
-        background = ResourceManager::loadTexture(renderer, "assets/menu/menu_background.png");
-    }
-    else
-    {
-        background = nullptr;
+        background = TextureRef(renderer, "assets/menu/menu_background.png");
     }
 
     initButtons(renderer);
@@ -18,7 +15,7 @@ Menu::Menu(SDL_Renderer *renderer, bool pause) : renderer(renderer), isPause(pau
 
 Menu::~Menu()
 {
-    // ResourceManager manages textures; call clear() at program shutdown if desired.
+    // TextureRefs release their references automatically.
 }
 
 void Menu::initButtons(SDL_Renderer *renderer)
@@ -106,7 +103,7 @@ void Menu::render()
     // Render background.
     if (!isPause && background)
     {
-        SDL_RenderCopy(renderer, background, nullptr, nullptr);
+        RenderStats::copy(renderer, background.get(), nullptr, nullptr);
     }
     // Render buttons.
     for (const auto &button : buttons)
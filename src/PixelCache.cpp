@@ -0,0 +1,215 @@
+#include "PixelCache.h"
+#include "Profiler.h"
+#include "AssetPack.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include <SDL2/SDL_image.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+namespace
+{
+    const char CACHE_MAGIC[4] = {'S', 'S', 'P', 'X'};
+
+    // Attached to a cache hit's surface so freeing it also unmaps the entry.
+    struct MappedPixels
+    {
+        const char *data;
+        size_t size;
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+std::string PixelCache::directory;
+std::mutex PixelCache::statsMutex;
+std::map<std::string, PixelCache::GroupStats> PixelCache::stats;
+
+void PixelCache::setDirectory(const std::string &dir)
+{
+    directory = dir;
+}
+
+SDL_Surface *PixelCache::load(const std::string &path)
+{
+    PROFILE_SCOPE("PixelCache::load");
+    if (directory.empty())
+        return IMG_Load_RW(AssetPack::open(path), 1);
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t stamp = 0;
+    bool stamped = sourceStamp(path, stamp);
+    std::string file = entryPath(path);
+
+    if (stamped)
+    {
+        std::uint64_t decodeMicros = 0;
+        SDL_Surface *cached = loadEntry(file, stamp, decodeMicros);
+        if (cached)
+        {
+            double ms = millisecondsSince(start);
+            std::lock_guard<std::mutex> lock(statsMutex);
+            GroupStats &group = stats[groupOf(path)];
+            group.hits++;
+            group.hitMs += ms;
+            group.savedMs += decodeMicros / 1000.0 - ms;
+            return cached;
+        }
+    }
+
+    SDL_Surface *decoded = IMG_Load_RW(AssetPack::open(path), 1);
+    if (!decoded)
+        return nullptr;
+    SDL_Surface *pixels = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(decoded);
+    if (!pixels)
+        return nullptr;
+
+    double ms = millisecondsSince(start);
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        GroupStats &group = stats[groupOf(path)];
+        group.misses++;
+        group.decodeMs += ms;
+    }
+    if (stamped)
+        writeEntry(file, pixels, stamp, static_cast<std::uint64_t>(ms * 1000.0));
+    return pixels;
+}
+
+void PixelCache::freeSurface(SDL_Surface *surface)
+{
+    if (!surface)
+        return;
+    MappedPixels *mapped = static_cast<MappedPixels *>(surface->userdata);
+    SDL_FreeSurface(surface);
+    if (mapped)
+    {
+        unmapFile(mapped->data, mapped->size);
+        delete mapped;
+    }
+}
+
+bool PixelCache::sourceStamp(const std::string &path, std::uint64_t &stamp)
+{
+    // Packed images are already mapped, so hashing them costs no I/O.
+    const char *data;
+    size_t size;
+    if (AssetPack::find(path, data, size))
+    {
+        stamp = hashBytes(data, size);
+        return true;
+    }
+
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+    std::uint64_t fields[2] = {static_cast<std::uint64_t>(info.st_size), static_cast<std::uint64_t>(info.st_mtime)};
+    stamp = hashBytes(reinterpret_cast<const char *>(fields), sizeof(fields));
+    return true;
+}
+
+std::string PixelCache::entryPath(const std::string &path)
+{
+    std::string key = AssetPack::normalizePath(path);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.px", static_cast<unsigned long long>(hashBytes(key.data(), key.size())));
+    return directory + "/" + name;
+}
+
+SDL_Surface *PixelCache::loadEntry(const std::string &file, std::uint64_t stamp, std::uint64_t &decodeMicros)
+{
+    size_t size = 0;
+    const char *data = mapFile(file, size);
+    if (!data)
+        return nullptr;
+
+    CacheHeader header = {};
+    if (size >= sizeof(CacheHeader))
+        std::memcpy(&header, data, sizeof(CacheHeader));
+    size_t pixelBytes = static_cast<size_t>(header.width) * header.height * 4;
+    SDL_Surface *surface = nullptr;
+    if (std::memcmp(header.magic, CACHE_MAGIC, 4) == 0 && header.version == VERSION &&
+        header.sourceStamp == stamp && header.width > 0 && header.height > 0 &&
+        size == sizeof(CacheHeader) + pixelBytes)
+    {
+        // SDL only reads these pixels; the mapping itself is read-only.
+        surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<char *>(data + sizeof(CacheHeader)),
+                                                     static_cast<int>(header.width), static_cast<int>(header.height),
+                                                     32, static_cast<int>(header.width * 4), SDL_PIXELFORMAT_RGBA32);
+    }
+    if (!surface)
+    {
+        unmapFile(data, size);
+        return nullptr;
+    }
+    surface->userdata = new MappedPixels{data, size};
+    decodeMicros = header.decodeMicros;
+    return surface;
+}
+
+void PixelCache::writeEntry(const std::string &file, SDL_Surface *surface, std::uint64_t stamp, std::uint64_t decodeMicros)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, 4);
+    header.version = VERSION;
+    header.width = static_cast<std::uint32_t>(surface->w);
+    header.height = static_cast<std::uint32_t>(surface->h);
+    header.sourceStamp = stamp;
+    header.decodeMicros = decodeMicros;
+
+    // Write beside the entry and rename, so a reader never maps half a file.
+    std::string tempPath = file + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        const char *row = static_cast<const char *>(surface->pixels);
+        for (int y = 0; y < surface->h; y++, row += surface->pitch)
+            out.write(row, static_cast<std::streamsize>(surface->w) * 4);
+        if (!out)
+        {
+            std::cerr << "Failed to write pixel cache entry " << tempPath << std::endl;
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, file, error);
+    if (error)
+        std::filesystem::remove(tempPath, error);
+}
+
+std::string PixelCache::groupOf(const std::string &path)
+{
+    std::string key = AssetPack::normalizePath(path);
+    if (key.compare(0, 7, "assets/") == 0)
+        key.erase(0, 7);
+    size_t slash = key.find('/');
+    if (slash == std::string::npos)
+        return "misc";
+    std::string group = key.substr(0, slash);
+    return group == "map" ? "tilesets" : group; // Tileset images live next to the maps.
+}
+
+void PixelCache::logStats()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const auto &entry : stats)
+    {
+        const GroupStats &group = entry.second;
+        std::printf("Pixel cache %-9s %3d hits (%7.2f ms, %7.2f ms of decoding saved), %3d misses (%7.2f ms decoding)\n",
+                    entry.first.c_str(), group.hits, group.hitMs, group.savedMs, group.misses, group.decodeMs);
+    }
+    stats.clear();
+}
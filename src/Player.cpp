@@ -9,30 +9,27 @@
 
 Player::Player(SDL_Renderer *renderer, Level *level)
     : velX(0), velY(0), isMoving(false),
-      renderer(renderer), level(level),
-      posX(400), posY(400),
+      renderer(renderer), level(level), animation(renderer),
+      posX(400), posY(400), prevX(400), prevY(400),
       bareFistAttacking(false), health(100), dead(false)
 {
     collisionBox = {static_cast<int>(posX) + PLAYER_COLLISION_OFFSET_X,
                     static_cast<int>(posY) + PLAYER_COLLISION_OFFSET_Y,
                     PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT};
-    animation = std::make_unique<PlayerAnimation>(renderer);
-    weapons = std::make_unique<PlayerWeapons>();
 
     // For a projectile weapon test:
-    // weapons->pickupWeapon(std::make_unique<ProjectileWeapon>(WeaponType::PISTOL, WEAPON_AMMO_PISTOL, WEAPON_FIRE_RATE_PISTOL, WEAPON_BULLET_SPEED_PISTOL, 10), renderer);
+    // weapons.pickupWeapon(ProjectileWeapon(WeaponType::PISTOL, WEAPON_AMMO_PISTOL, WEAPON_FIRE_RATE_PISTOL, WEAPON_BULLET_SPEED_PISTOL, 10), renderer);
 
-    weapons->pickupWeapon(std::make_unique<MeleeWeapon>(
-                              WeaponType::BASEBALL_BAT, WEAPON_FIRE_RATE_MELEE, 5),
+    weapons.pickupWeapon(MeleeWeapon(WeaponType::BASEBALL_BAT, WEAPON_FIRE_RATE_MELEE, 5),
                           renderer);
 }
 
 Player::~Player()
 {
-    // Smart pointers handle resource cleanup.
+    // Members release their texture references.
 }
 
-void Player::updateInput(const Uint8 *keys)
+void Player::updateInput(const InputCommand &command)
 {
     if (dead)
     {
@@ -42,7 +39,7 @@ void Player::updateInput(const Uint8 *keys)
         return;
     }
 
-    InputManager::processInput(keys, velX, velY, isMoving);
+    InputManager::processInput(command, velX, velY, isMoving);
     if (velX != 0.0f && velY != 0.0f)
     {
         velX *= 0.7071f;
@@ -50,29 +47,30 @@ void Player::updateInput(const Uint8 *keys)
     }
 }
 
-void Player::shoot(int mouseX, int mouseY, int cameraX, int cameraY)
+void Player::shoot(float targetX, float targetY, EventBus &events)
 {
     if (dead)
         return;
 
     float centerX = posX + spriteWidth / 2;
     float centerY = posY + spriteHeight / 2;
-    float worldMouseX = mouseX + cameraX;
-    float worldMouseY = mouseY + cameraY;
 
-    if (weapons->hasWeapon())
+    if (weapons.hasWeapon())
     {
-        weapons->shoot(bullets, centerX, centerY, worldMouseX, worldMouseY);
+        weapons.shoot(bullets, centerX, centerY, targetX, targetY, events);
     }
     else
     {
-        if (!animation->isAttacking())
-            animation->triggerAttack();
+        if (!animation.isAttacking())
+            animation.triggerAttack();
     }
 }
 
 void Player::update(int screenWidth, int screenHeight)
 {
+    prevX = posX;
+    prevY = posY;
+
     float newX = posX + velX;
     float newY = posY + velY;
 
@@ -83,24 +81,25 @@ void Player::update(int screenWidth, int screenHeight)
     if (!CollisionHandler::checkCollision({static_cast<int>(newX) + PLAYER_COLLISION_OFFSET_X,
                                            static_cast<int>(posY) + PLAYER_COLLISION_OFFSET_Y,
                                            PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT},
-                                          level->getCollisionTiles()))
+                                          level->getCollisionGrid()))
     {
         posX = newX;
     }
     if (!CollisionHandler::checkCollision({static_cast<int>(posX) + PLAYER_COLLISION_OFFSET_X,
                                            static_cast<int>(newY) + PLAYER_COLLISION_OFFSET_Y,
                                            PLAYER_COLLISION_WIDTH, PLAYER_COLLISION_HEIGHT},
-                                          level->getCollisionTiles()))
+                                          level->getCollisionGrid()))
     {
         posY = newY;
     }
 
-    weapons->update();
-    animation->update(isMoving);
+    weapons.update();
+    animation.update(isMoving);
+    if (dead)
+        animation.updateDead();
 
-    // Update bullets using a fixed delta time (could be adjusted)
     for (auto &bullet : bullets)
-        bullet.update(1.0, screenWidth, screenHeight);
+        bullet.update(FIXED_TIMESTEP, screenWidth, screenHeight);
 
     bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
                                  [](const Bullet &b)
@@ -108,15 +107,15 @@ void Player::update(int screenWidth, int screenHeight)
                   bullets.end());
 }
 
-void Player::render(SDL_Renderer *renderer, int cameraX, int cameraY)
+void Player::render(SDL_Renderer *renderer, int cameraX, int cameraY, float alpha)
 {
-    float renderX = posX - cameraX;
-    float renderY = posY - cameraY;
+    float renderX = prevX + (posX - prevX) * alpha - cameraX;
+    float renderY = prevY + (posY - prevY) * alpha - cameraY;
 
     if (dead)
     {
         // Render player's dead animation.
-        animation->renderDead(renderer, renderX, renderY, angle);
+        animation.renderDead(renderer, renderX, renderY, angle);
     }
     else
     {
@@ -126,20 +125,20 @@ void Player::render(SDL_Renderer *renderer, int cameraX, int cameraY)
             legsAngle = atan2(velY, velX) * (180.0f / M_PI);
         }
 
-        animation->renderLegs(renderer, renderX, renderY, legsAngle);
+        animation.renderLegs(renderer, renderX, renderY, legsAngle);
         // If a weapon is held, use the attached animation versions.
-        if (weapons->hasWeapon())
+        if (weapons.hasWeapon())
         {
-            animation->renderAttached(renderer, renderX, renderY, angle);
+            animation.renderAttached(renderer, renderX, renderY, angle);
         }
         else
         {
-            animation->render(renderer, renderX, renderY, angle);
+            animation.render(renderer, renderX, renderY, angle);
         }
         // Render weapon effects (fire animations, etc.) on top of the player.
-        weapons->render(renderer, renderX, renderY, angle);
+        weapons.render(renderer, renderX, renderY, angle);
     }
 
     for (auto &bullet : bullets)
-        bullet.render(renderer, cameraX, cameraY);
+        bullet.render(renderer, cameraX, cameraY, alpha);
 }
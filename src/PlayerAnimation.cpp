@@ -1,25 +1,25 @@
 #include "PlayerAnimation.h"
-#include <SDL2/SDL_image.h>
-#include <iostream>
+#include "RenderStats.h"
+#include "Sprites.h"
 #include <cmath>
 
 PlayerAnimation::PlayerAnimation(SDL_Renderer *renderer)
     : frame(0), frameTime(0), currentState(AnimationState::IDLE), deathFrame(0), deathFrameTime(0), rightHand(true)
 {
-    idleTexture = loadTexture(renderer, "assets/player/player_idle.png");
-    runTexture = loadTexture(renderer, "assets/player/player_run.png");
-    attackTexture = loadTexture(renderer, "assets/player/player_punch.png");
+    idleTexture = TextureRef(renderer, Sprites::PLAYER_IDLE);
+    runTexture = TextureRef(renderer, Sprites::PLAYER_RUN);
+    attackTexture = TextureRef(renderer, Sprites::PLAYER_PUNCH);
 
-    attachedIdleTexture = loadTexture(renderer, "assets/player/player_idle_attached.png");
-    attachedRunTexture = loadTexture(renderer, "assets/player/player_run_attached.png");
+    attachedIdleTexture = TextureRef(renderer, Sprites::PLAYER_IDLE_ATTACHED);
+    attachedRunTexture = TextureRef(renderer, Sprites::PLAYER_RUN_ATTACHED);
 
-    deadTexture = loadTexture(renderer, "assets/player/player_dead.png");
+    deadTexture = TextureRef(renderer, Sprites::PLAYER_DEAD);
 
-    legsTexture = loadTexture(renderer, "assets/player/player_legs.png");
+    legsTexture = TextureRef(renderer, Sprites::PLAYER_LEGS);
     legsFrame = 0;
     legsFrameTime = 0;
 
-    deadEffectTexture = loadTexture(renderer, "assets/effect.png");
+    deadEffectTexture = TextureRef(renderer, Sprites::DEATH_EFFECT);
     deadEffectFrame = 0;
     deadEffectFrameTime = 0;
     deadEffectDelayCounter = 0;
@@ -27,27 +27,7 @@ PlayerAnimation::PlayerAnimation(SDL_Renderer *renderer)
 
 PlayerAnimation::~PlayerAnimation()
 {
-    // Unique pointers auto-clean.
-}
-
-std::unique_ptr<SDL_Texture, SDLTextureDeleter> PlayerAnimation::loadTexture(SDL_Renderer *renderer, const char *path)
-{
-    SDL_Surface *surface = IMG_Load(path);
-    if (!surface)
-    {
-        std::cerr << "Failed to load surface: " << path
-                  << " SDL_Error: " << SDL_GetError() << std::endl;
-        return nullptr;
-    }
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!tex)
-    {
-        std::cerr << "Failed to create texture: " << path
-                  << " SDL_Error: " << SDL_GetError() << std::endl;
-        return nullptr;
-    }
-    return std::unique_ptr<SDL_Texture, SDLTextureDeleter>(tex);
+    // TextureRefs release their references automatically.
 }
 
 void PlayerAnimation::triggerAttack()
@@ -153,7 +133,7 @@ void PlayerAnimation::render(SDL_Renderer *renderer, float x, float y, float ang
     SDL_Rect destRect = {static_cast<int>(x), static_cast<int>(y), spriteWidth, spriteHeight};
     SDL_Point center = {spriteWidth / 2, spriteHeight / 2};
 
-    SDL_RenderCopyEx(renderer, currentTex, &srcRect, &destRect, angle, &center, flip);
+    RenderStats::copyEx(renderer, currentTex, &srcRect, &destRect, angle, &center, flip);
 }
 
 void PlayerAnimation::renderAttached(SDL_Renderer *renderer, float x, float y, float angle)
@@ -183,7 +163,7 @@ void PlayerAnimation::renderAttached(SDL_Renderer *renderer, float x, float y, f
     SDL_Rect srcRect = {frame * spriteWidth, 0, spriteWidth, spriteHeight};
     SDL_Rect destRect = {static_cast<int>(x), static_cast<int>(y), spriteWidth, spriteHeight};
     SDL_Point center = {spriteWidth / 2, spriteHeight / 2};
-    SDL_RenderCopyEx(renderer, currentTex, &srcRect, &destRect, angle, &center, flip);
+    RenderStats::copyEx(renderer, currentTex, &srcRect, &destRect, angle, &center, flip);
 }
 
 void PlayerAnimation::renderDead(SDL_Renderer *renderer, float x, float y, float angle)
@@ -195,8 +175,11 @@ void PlayerAnimation::renderDead(SDL_Renderer *renderer, float x, float y, float
     SDL_Rect srcRect = {deathFrame * 100, 0, 100, 54};
     SDL_Rect destRect = {static_cast<int>(x) - (100 - 54) / 2, static_cast<int>(y), 100, 54};
     SDL_Point center = {50, 27};
-    SDL_RenderCopyEx(renderer, deadTexture.get(), &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
+    RenderStats::copyEx(renderer, deadTexture.get(), &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
+}
 
+void PlayerAnimation::updateDead()
+{
     // Advance death animation until last frame is reached.
     deathFrameTime++;
     if (deathFrameTime >= DEATH_FRAME_SPEED)
@@ -207,6 +190,20 @@ void PlayerAnimation::renderDead(SDL_Renderer *renderer, float x, float y, float
         }
         deathFrameTime = 0;
     }
+
+    // The effect starts after a delay, then plays once and holds its last frame.
+    if (deadEffectDelayCounter < deadEffectDelayThreshold)
+    {
+        deadEffectDelayCounter++;
+        return;
+    }
+    deadEffectFrameTime++;
+    if (deadEffectFrameTime >= DEAD_EFFECT_SPEED)
+    {
+        if (deadEffectFrame < DEAD_EFFECT_FRAMES - 1)
+            deadEffectFrame++;
+        deadEffectFrameTime = 0;
+    }
 }
 
 void PlayerAnimation::renderLegs(SDL_Renderer *renderer, float x, float y, float legsAngle)
@@ -217,7 +214,7 @@ void PlayerAnimation::renderLegs(SDL_Renderer *renderer, float x, float y, float
     SDL_Rect srcRect = {legsFrame * spriteWidth, 0, spriteWidth, spriteHeight};
     SDL_Rect destRect = {static_cast<int>(x), static_cast<int>(y), spriteWidth, spriteHeight};
     SDL_Point center = {spriteWidth / 2, spriteHeight / 2};
-    SDL_RenderCopyEx(renderer, legsTexture.get(), &srcRect, &destRect, legsAngle, &center, SDL_FLIP_NONE);
+    RenderStats::copyEx(renderer, legsTexture.get(), &srcRect, &destRect, legsAngle, &center, SDL_FLIP_NONE);
 }
 
 void PlayerAnimation::renderDeathEffect(SDL_Renderer *renderer, float x, float y, float angle)
@@ -227,10 +224,7 @@ void PlayerAnimation::renderDeathEffect(SDL_Renderer *renderer, float x, float y
 
     // Only start drawing the effect after the delay threshold.
     if (deadEffectDelayCounter < deadEffectDelayThreshold)
-    {
-        deadEffectDelayCounter++;
         return; // Skip drawing until delay is reached.
-    }
 
     const int effectWidth = 98, effectHeight = 54;
     SDL_Rect srcRect = {deadEffectFrame * effectWidth, 0, effectWidth, effectHeight};
@@ -242,15 +236,7 @@ void PlayerAnimation::renderDeathEffect(SDL_Renderer *renderer, float x, float y
     destRect.x += offsetX;
     destRect.y += offsetY;
     SDL_Point center = {effectWidth / 2, effectHeight / 2};
-    SDL_RenderCopyEx(renderer, deadEffectTexture.get(), &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
-
-    deadEffectFrameTime++;
-    if (deadEffectFrameTime >= DEAD_EFFECT_SPEED)
-    {
-        if (deadEffectFrame < DEAD_EFFECT_FRAMES - 1)
-            deadEffectFrame++;
-        deadEffectFrameTime = 0;
-    }
+    RenderStats::copyEx(renderer, deadEffectTexture.get(), &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
 }
 
 void PlayerAnimation::reset()
@@ -1,4 +1,6 @@
 #include "PlayerWeapons.h"
+#include "Constants.h"
+#include "EventBus.h"
 #include <utility>
 
 PlayerWeapons::PlayerWeapons()
@@ -7,13 +9,13 @@ PlayerWeapons::PlayerWeapons()
 
 PlayerWeapons::~PlayerWeapons()
 {
-    // Unique pointers auto-clean.
+    // Weapons are held by value and clean up with this object.
 }
 
-void PlayerWeapons::pickupWeapon(std::unique_ptr<AbstractWeapon> newWeapon, SDL_Renderer *renderer)
+void PlayerWeapons::pickupWeapon(Weapon newWeapon, SDL_Renderer *renderer)
 {
     // Initialize the weapon's textures using the provided renderer.
-    newWeapon->initialize(renderer);
+    newWeapon.initialize(renderer);
     if (!currentWeapon)
     {
         currentWeapon = std::move(newWeapon);
@@ -26,15 +28,15 @@ void PlayerWeapons::pickupWeapon(std::unique_ptr<AbstractWeapon> newWeapon, SDL_
     }
 }
 
-std::unique_ptr<AbstractWeapon> PlayerWeapons::dropWeapon(float playerX, float playerY)
+std::optional<Weapon> PlayerWeapons::dropWeapon(float playerX, float playerY)
 {
     if (currentWeapon)
     {
         currentWeapon->setPosition(playerX, playerY);
         // Release the current weapon to the caller.
-        return std::move(currentWeapon);
+        return releaseCurrentWeapon();
     }
-    return nullptr;
+    return std::nullopt;
 }
 
 void PlayerWeapons::render(SDL_Renderer *renderer, float playerX, float playerY, float angle)
@@ -50,40 +52,35 @@ void PlayerWeapons::update()
     if (currentWeapon)
         currentWeapon->update();
 
-    fireTimer += 1.0f / 60.0f;
+    fireTimer += FIXED_TIMESTEP;
 }
 
-void PlayerWeapons::shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY)
+void PlayerWeapons::shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY, EventBus &events)
 {
     if (currentWeapon)
     {
         if (fireTimer < currentWeapon->getFireRate())
             return;
-        currentWeapon->shoot(bullets, playerX, playerY, aimX, aimY);
+        currentWeapon->shoot(bullets, playerX, playerY, aimX, aimY, &events, EventTarget::PLAYER);
         fireTimer = 0.0f;
     }
 }
 
 bool PlayerWeapons::hasWeapon() const
 {
-    return (currentWeapon != nullptr);
+    return currentWeapon.has_value();
 }
 
-std::unique_ptr<AbstractWeapon> PlayerWeapons::releaseCurrentWeapon()
+std::optional<Weapon> PlayerWeapons::releaseCurrentWeapon()
 {
-    // This returns the current weapon and sets currentWeapon to nullptr.
-    return std::move(currentWeapon);
+    // This returns the current weapon and leaves currentWeapon empty.
+    std::optional<Weapon> released = std::move(currentWeapon);
+    currentWeapon.reset();
+    return released;
 }
 
 bool PlayerWeapons::isAttacking() const
 {
     // Only melee weapons have an attack state.
-    if (currentWeapon && currentWeapon->isMelee())
-    {
-        // For melee weapons, downcast and check:
-        const MeleeWeapon *mw = dynamic_cast<const MeleeWeapon *>(currentWeapon.get());
-        if (mw)
-            return mw->isCurrentlyAttacking();
-    }
-    return false;
+    return currentWeapon && currentWeapon->isAttacking();
 }
@@ -0,0 +1,199 @@
+#include "Profiler.h"
+#include "json.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Written by the owning thread while writeTrace() may be reading, so
+    // every field is a relaxed atomic; the buffer's `written` count says
+    // which slots are complete.
+    struct Zone
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<std::uint64_t> startNs{0}, endNs{0};
+    };
+
+    // Ring of the last ZONES_PER_THREAD zones of one thread, which is the
+    // only writer. When the thread exits the buffer, with the zones in it,
+    // goes back to the registry for the next new thread, so short-lived
+    // threads (std::async, loader workers) do not each allocate a ring.
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Zone[]> zones = std::make_unique<Zone[]>(Profiler::ZONES_PER_THREAD);
+        std::atomic<std::uint64_t> written{0}; // Zones ever recorded; published with release.
+        int id = 0;
+        std::string name; // Guarded by the registry mutex.
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::vector<ThreadBuffer *> idle; // Buffers whose thread has exited.
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    Registry &registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    ThreadBuffer *acquireBuffer()
+    {
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        ThreadBuffer *buffer;
+        if (!shared.idle.empty())
+        {
+            buffer = shared.idle.back();
+            shared.idle.pop_back();
+        }
+        else
+        {
+            shared.buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = shared.buffers.back().get();
+            buffer->id = static_cast<int>(shared.buffers.size());
+        }
+        buffer->name = "thread " + std::to_string(buffer->id);
+        return buffer;
+    }
+
+    // Holds the calling thread's buffer and hands it back when the thread exits.
+    struct BufferLease
+    {
+        ThreadBuffer *buffer = acquireBuffer();
+
+        ~BufferLease()
+        {
+            Registry &shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.idle.push_back(buffer);
+        }
+    };
+
+    ThreadBuffer &localBuffer()
+    {
+        thread_local BufferLease lease;
+        return *lease.buffer;
+    }
+
+#if PROFILER_ENABLED
+    struct ZoneCopy
+    {
+        const char *name;
+        std::uint64_t startNs, endNs;
+    };
+
+    // Copies the complete zones of buffer without stopping its thread. Slots
+    // the thread overwrote (or was overwriting) during the copy are dropped.
+    std::vector<ZoneCopy> snapshot(const ThreadBuffer &buffer)
+    {
+        const std::uint64_t capacity = Profiler::ZONES_PER_THREAD;
+        std::uint64_t end = buffer.written.load(std::memory_order_acquire);
+        std::uint64_t begin = end - std::min(end, capacity);
+
+        std::vector<ZoneCopy> zones;
+        zones.reserve(end - begin);
+        for (std::uint64_t i = begin; i < end; i++)
+        {
+            const Zone &zone = buffer.zones[i % capacity];
+            zones.push_back({zone.name.load(std::memory_order_relaxed), zone.startNs.load(std::memory_order_relaxed),
+                             zone.endNs.load(std::memory_order_relaxed)});
+        }
+
+        // Pairs with the fence in record(): any slot write seen above makes
+        // the count before it visible here. Slot `after` may be mid-write.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t after = buffer.written.load(std::memory_order_relaxed);
+        std::uint64_t firstValid = after + 1 > capacity ? after + 1 - capacity : 0;
+        if (firstValid > begin)
+            zones.erase(zones.begin(), zones.begin() + std::min(firstValid - begin, end - begin));
+        return zones;
+    }
+#endif
+}
+
+std::uint64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void Profiler::record(const char *name, std::uint64_t startNs, std::uint64_t endNs)
+{
+    ThreadBuffer &buffer = localBuffer();
+    std::uint64_t index = buffer.written.load(std::memory_order_relaxed); // Only this thread writes it.
+
+    // Orders the previous count before this slot's writes, so a reader that
+    // sees any of them also sees that the slot is being reused.
+    std::atomic_thread_fence(std::memory_order_release);
+    Zone &zone = buffer.zones[index % ZONES_PER_THREAD];
+    zone.name.store(name, std::memory_order_relaxed);
+    zone.startNs.store(startNs, std::memory_order_relaxed);
+    zone.endNs.store(endNs, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name)
+{
+    ThreadBuffer &buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+bool Profiler::writeTrace(const std::string &path)
+{
+#if PROFILER_ENABLED
+    using json = nlohmann::json;
+
+    // Buffers are never freed, so the pointers outlive the lock.
+    std::vector<const ThreadBuffer *> buffers;
+    std::vector<std::string> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        for (const auto &buffer : registry().buffers)
+        {
+            buffers.push_back(buffer.get());
+            threadNames.push_back(buffer->name);
+        }
+    }
+
+    // Complete ("X") events with microsecond times, plus a name per thread.
+    json events = json::array();
+    size_t zoneCount = 0;
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        const ThreadBuffer *buffer = buffers[b];
+        std::vector<ZoneCopy> zones = snapshot(*buffer);
+
+        events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buffer->id},
+                          {"args", {{"name", threadNames[b]}}}});
+        for (const ZoneCopy &zone : zones)
+        {
+            events.push_back({{"name", zone.name}, {"ph", "X"}, {"pid", 1}, {"tid", buffer->id},
+                              {"ts", zone.startNs / 1000.0}, {"dur", (zone.endNs - zone.startNs) / 1000.0}});
+        }
+        zoneCount += zones.size();
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    out << json{{"traceEvents", events}, {"displayTimeUnit", "ns"}}.dump();
+    if (!out)
+    {
+        SDL_Log("Failed to write profiler trace %s", path.c_str());
+        return false;
+    }
+    SDL_Log("Profiler trace: %zu zones from %zu threads written to %s", zoneCount, buffers.size(), path.c_str());
+    return true;
+#else
+    SDL_Log("Profiler is compiled out of this build; no trace written to %s", path.c_str());
+    return false;
+#endif
+}
@@ -0,0 +1,12 @@
+#include "RenderStats.h"
+
+RenderStats::Frame RenderStats::frame;
+SDL_Rect RenderStats::output = {0, 0, 0, 0};
+
+void RenderStats::beginFrame(SDL_Renderer *renderer)
+{
+    frame = Frame();
+    int w = 0, h = 0;
+    if (renderer && SDL_GetRendererOutputSize(renderer, &w, &h) == 0)
+        output = {0, 0, w, h};
+}
@@ -1,9 +1,11 @@
 #include "Renderer.h"
+#include "RenderStats.h"
 #include <iostream>
 
-Renderer::Renderer(SDL_Window *window)
+Renderer::Renderer(SDL_Window *window, bool software)
 {
-    SDL_Renderer *rawRenderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 flags = software ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+    SDL_Renderer *rawRenderer = SDL_CreateRenderer(window, -1, flags);
     if (!rawRenderer)
     {
         std::cerr << "Failed to create renderer: " << SDL_GetError() << std::endl;
@@ -28,7 +30,25 @@ void Renderer::present()
     SDL_RenderPresent(renderer.get());
 }
 
+bool Renderer::setVSync(bool enabled)
+{
+    if (SDL_RenderSetVSync(renderer.get(), enabled ? 1 : 0) != 0)
+    {
+        std::cerr << "Failed to change vsync: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Renderer::hasVSync() const
+{
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer.get(), &info) != 0)
+        return false;
+    return (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+}
+
 void Renderer::drawTexture(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst, double angle, SDL_Point *center, SDL_RendererFlip flip)
 {
-    SDL_RenderCopyEx(renderer.get(), texture, src, dst, angle, center, flip);
+    RenderStats::copyEx(renderer.get(), texture, src, dst, angle, center, flip);
 }
@@ -0,0 +1,208 @@
+#include "Replay.h"
+#include "Hash.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char REPLAY_MAGIC[4] = {'S', 'S', 'R', 'P'};
+    const int ACTION_COUNT = static_cast<int>(InputAction::COUNT);
+
+    // Fixed part of a tick record; pressed actions follow it.
+    struct TickRecord
+    {
+        std::uint8_t pressed;
+        std::int8_t moveX, moveY;
+        std::uint8_t reserved;
+        float aimX, aimY;
+        std::uint32_t checksum;
+    };
+
+    struct PressRecord
+    {
+        float x, y;
+        std::uint32_t timestamp;
+    };
+
+    template <typename Record>
+    void append(std::vector<char> &out, const Record &record)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&record);
+        out.insert(out.end(), bytes, bytes + sizeof(Record));
+    }
+
+    template <typename Record>
+    bool take(const std::vector<char> &in, size_t &offset, Record &record)
+    {
+        if (in.size() - offset < sizeof(Record))
+            return false;
+        std::memcpy(&record, in.data() + offset, sizeof(Record));
+        offset += sizeof(Record);
+        return true;
+    }
+}
+
+void Replay::startRecording(std::uint64_t recordSeed, int recordMapIndex)
+{
+    mode = Mode::RECORDING;
+    seed = recordSeed;
+    mapIndex = recordMapIndex;
+    ticks.clear();
+    cursor = 0;
+    desyncTick = -1;
+}
+
+void Replay::record(const InputCommand &command, std::uint32_t checksum)
+{
+    if (mode == Mode::RECORDING)
+        ticks.push_back({command, checksum});
+}
+
+bool Replay::save(const std::string &path) const
+{
+    std::vector<char> bytes(sizeof(ReplayHeader));
+    for (const Tick &tick : ticks)
+    {
+        const InputCommand &command = tick.command;
+        TickRecord record = {command.pressed, command.moveX, command.moveY, 0,
+                             command.aimX, command.aimY, tick.checksum};
+        append(bytes, record);
+        for (int i = 0; i < ACTION_COUNT; i++)
+        {
+            if (!command.wasPressed(static_cast<InputAction>(i)))
+                continue;
+            const InputPress &press = command.presses[i];
+            append(bytes, PressRecord{press.x, press.y, press.timestamp});
+        }
+    }
+
+    ReplayHeader header = {};
+    std::memcpy(header.magic, REPLAY_MAGIC, 4);
+    header.version = VERSION;
+    header.seed = seed;
+    header.mapIndex = mapIndex;
+    header.tickCount = static_cast<std::uint32_t>(ticks.size());
+    header.payloadSize = bytes.size() - sizeof(ReplayHeader);
+    header.payloadHash = hashBytes(bytes.data() + sizeof(ReplayHeader), header.payloadSize);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+        {
+            std::cerr << "Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::cerr << "Failed to replace " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        std::cerr << "No replay at " << path << std::endl;
+        return false;
+    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    ReplayHeader header;
+    if (!file || bytes.size() < sizeof(header))
+    {
+        std::cerr << "Replay " << path << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, REPLAY_MAGIC, 4) != 0 || header.version != VERSION ||
+        header.payloadSize != bytes.size() - sizeof(header) ||
+        header.payloadHash != hashBytes(bytes.data() + sizeof(header), header.payloadSize))
+    {
+        std::cerr << "Replay " << path << " is corrupt or from another version" << std::endl;
+        return false;
+    }
+    // The hash does not cover the header, so bound tickCount by what the
+    // payload can hold before reserving for it.
+    if (header.tickCount > header.payloadSize / sizeof(TickRecord))
+    {
+        std::cerr << "Replay " << path << " claims more ticks than it holds" << std::endl;
+        return false;
+    }
+
+    std::vector<Tick> loaded;
+    loaded.reserve(header.tickCount);
+    size_t offset = sizeof(header);
+    for (std::uint32_t i = 0; i < header.tickCount; i++)
+    {
+        TickRecord record;
+        if (!take(bytes, offset, record) || record.pressed >> ACTION_COUNT)
+        {
+            std::cerr << "Replay " << path << " has a bad record at tick " << i << std::endl;
+            return false;
+        }
+        Tick tick;
+        tick.command.pressed = record.pressed;
+        tick.command.moveX = record.moveX;
+        tick.command.moveY = record.moveY;
+        tick.command.aimX = record.aimX;
+        tick.command.aimY = record.aimY;
+        tick.checksum = record.checksum;
+        for (int action = 0; action < ACTION_COUNT; action++)
+        {
+            if (!tick.command.wasPressed(static_cast<InputAction>(action)))
+                continue;
+            PressRecord press;
+            if (!take(bytes, offset, press))
+            {
+                std::cerr << "Replay " << path << " is truncated at tick " << i << std::endl;
+                return false;
+            }
+            tick.command.presses[action] = {press.x, press.y, press.timestamp};
+        }
+        loaded.push_back(tick);
+    }
+    if (offset != bytes.size())
+    {
+        std::cerr << "Replay " << path << " has data past its last tick" << std::endl;
+        return false;
+    }
+
+    ticks = std::move(loaded);
+    seed = header.seed;
+    mapIndex = header.mapIndex;
+    cursor = 0;
+    desyncTick = -1;
+    mode = Mode::PLAYING;
+    return true;
+}
+
+bool Replay::next(InputCommand &command)
+{
+    if (mode != Mode::PLAYING || cursor >= ticks.size())
+        return false;
+    command = ticks[cursor++].command;
+    return true;
+}
+
+bool Replay::verify(std::uint32_t checksum)
+{
+    if (cursor == 0 || ticks[cursor - 1].checksum == checksum)
+        return true;
+    if (desyncTick < 0)
+        desyncTick = static_cast<long>(cursor - 1);
+    return false;
+}
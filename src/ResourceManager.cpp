@@ -1,30 +1,233 @@
 #include "ResourceManager.h"
+#include "Profiler.h"
+#include "AssetLoader.h"
+#include "PixelCache.h"
+#include "Constants.h"
+#include <algorithm>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 
-std::unordered_map<std::string, SDL_Texture *> ResourceManager::textureCache;
+// Slot 0 backs INVALID_TEXTURE_HANDLE.
+std::vector<ResourceManager::TextureEntry> ResourceManager::textures = {{"", nullptr, 0, ResourceManager::TextureState::FAILED, 0, 0}};
+std::unordered_map<std::string, TextureHandle> ResourceManager::handlesByPath;
+std::unique_ptr<AssetLoader> ResourceManager::loader;
+int ResourceManager::pendingCount = 0;
+size_t ResourceManager::textureBudget = TEXTURE_MEMORY_BUDGET;
+size_t ResourceManager::residentBytes = 0;
+int ResourceManager::evictionCount = 0;
+std::uint64_t ResourceManager::useClock = 0;
 
-SDL_Texture *ResourceManager::loadTexture(SDL_Renderer *renderer, const std::string &path)
+AssetLoader &ResourceManager::getLoader()
 {
-    auto it = textureCache.find(path);
-    if (it != textureCache.end())
+    if (!loader)
+        loader = std::make_unique<AssetLoader>();
+    return *loader;
+}
+
+TextureHandle ResourceManager::intern(const std::string &path, TextureState state)
+{
+    TextureHandle handle = static_cast<TextureHandle>(textures.size());
+    textures.push_back({path, nullptr, 0, state, 0, 0});
+    handlesByPath[path] = handle;
+    return handle;
+}
+
+bool ResourceManager::createTexture(SDL_Renderer *renderer, TextureEntry &entry, SDL_Surface *surface)
+{
+    PROFILE_SCOPE("ResourceManager::createTexture");
+    if (surface)
+    {
+        if (surface->format->format == SDL_PIXELFORMAT_RGBA32)
+        {
+            // Pixel cache output is already in upload format: no conversion pass.
+            entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+            if (entry.texture)
+            {
+                SDL_UpdateTexture(entry.texture, nullptr, surface->pixels, surface->pitch);
+                SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND);
+            }
+        }
+        else
+            entry.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (entry.texture)
+        {
+            // The renderer may have picked its own format; YUV and unknown formats count as 4 bytes.
+            Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+            SDL_QueryTexture(entry.texture, &format, nullptr, nullptr, nullptr);
+            size_t bytesPerPixel = SDL_BYTESPERPIXEL(format) ? SDL_BYTESPERPIXEL(format) : 4;
+            entry.bytes = static_cast<size_t>(surface->w) * surface->h * bytesPerPixel;
+        }
+        PixelCache::freeSurface(surface);
+    }
+    if (!entry.texture)
+    {
+        SDL_Log("Failed to load texture: %s, SDL_Error: %s", entry.path.c_str(), SDL_GetError());
+        entry.state = TextureState::FAILED;
+        return false;
+    }
+    entry.state = TextureState::RESIDENT;
+    residentBytes += entry.bytes;
+    touch(entry);
+    return true;
+}
+
+TextureHandle ResourceManager::acquireTexture(SDL_Renderer *renderer, const std::string &path)
+{
+    TextureHandle handle;
+    auto it = handlesByPath.find(path);
+    if (it == handlesByPath.end())
+    {
+        handle = intern(path, TextureState::FAILED);
+        createTexture(renderer, textures[handle], PixelCache::load(path));
+    }
+    else
+    {
+        handle = it->second;
+        if (textures[handle].state == TextureState::DECODING)
+        {
+            // Needed now: wait for (or take over) the background decode.
+            pendingCount--;
+            createTexture(renderer, textures[handle], getLoader().take(path));
+        }
+        else if (textures[handle].state == TextureState::EVICTED)
+            createTexture(renderer, textures[handle], PixelCache::load(path));
+    }
+
+    if (textures[handle].state != TextureState::RESIDENT)
+        return INVALID_TEXTURE_HANDLE;
+    textures[handle].refCount++;
+    touch(textures[handle]);
+    evictToBudget();
+    return handle;
+}
+
+TextureHandle ResourceManager::prefetchTexture(const std::string &path)
+{
+    auto it = handlesByPath.find(path);
+    TextureHandle handle;
+    if (it == handlesByPath.end())
+        handle = intern(path, TextureState::DECODING);
+    else if (textures[it->second].state == TextureState::EVICTED)
+    {
+        handle = it->second;
+        textures[handle].state = TextureState::DECODING;
+    }
+    else
         return it->second;
-    SDL_Texture *tex = IMG_LoadTexture(renderer, path.c_str());
-    if (!tex)
+
+    pendingCount++;
+    getLoader().request(path);
+    return handle;
+}
+
+void ResourceManager::prefetchTextures(const std::vector<std::string> &paths)
+{
+    for (const auto &path : paths)
+        prefetchTexture(path);
+}
+
+int ResourceManager::uploadPendingTextures(SDL_Renderer *renderer, int maxCount)
+{
+    if (pendingCount == 0 || maxCount <= 0)
+        return 0;
+
+    std::vector<std::pair<std::string, SDL_Surface *>> decoded;
+    getLoader().collect(decoded, static_cast<size_t>(maxCount));
+    for (auto &result : decoded)
     {
-        SDL_Log("Failed to load texture: %s, SDL_Error: %s", path.c_str(), SDL_GetError());
-        return nullptr;
+        TextureEntry &entry = textures[handlesByPath.at(result.first)];
+        pendingCount--;
+        createTexture(renderer, entry, result.second);
     }
-    textureCache[path] = tex;
-    return tex;
+    evictToBudget();
+    return static_cast<int>(decoded.size());
+}
+
+const std::string &ResourceManager::getPath(TextureHandle handle)
+{
+    static const std::string none;
+    return handle < textures.size() ? textures[handle].path : none;
+}
+
+void ResourceManager::addReference(TextureHandle handle)
+{
+    if (handle != INVALID_TEXTURE_HANDLE && handle < textures.size())
+    {
+        textures[handle].refCount++;
+        touch(textures[handle]);
+    }
+}
+
+void ResourceManager::releaseTexture(TextureHandle handle)
+{
+    // Unreferenced textures stay resident, so the next level or restart can
+    // reuse them, until the budget needs their memory.
+    if (handle != INVALID_TEXTURE_HANDLE && handle < textures.size() && textures[handle].refCount > 0)
+    {
+        textures[handle].refCount--;
+        touch(textures[handle]);
+        if (textures[handle].refCount == 0)
+            evictToBudget();
+    }
+}
+
+void ResourceManager::setTextureBudget(size_t bytes)
+{
+    textureBudget = bytes;
+    evictToBudget();
+}
+
+void ResourceManager::evictToBudget()
+{
+    while (residentBytes > textureBudget)
+    {
+        // Least recently used unreferenced texture; a linear scan is fine for
+        // a few hundred entries and only runs while over budget.
+        TextureEntry *victim = nullptr;
+        for (auto &entry : textures)
+        {
+            if (entry.state == TextureState::RESIDENT && entry.refCount == 0 &&
+                (!victim || entry.lastUsed < victim->lastUsed))
+                victim = &entry;
+        }
+        if (!victim)
+            return; // Everything left is in use.
+
+        SDL_DestroyTexture(victim->texture);
+        victim->texture = nullptr;
+        residentBytes -= victim->bytes;
+        victim->bytes = 0;
+        victim->state = TextureState::EVICTED;
+        evictionCount++;
+    }
+}
+
+std::vector<ResourceManager::TextureInfo> ResourceManager::getResidentTextures()
+{
+    std::vector<TextureInfo> resident;
+    for (const auto &entry : textures)
+    {
+        if (entry.state == TextureState::RESIDENT)
+            resident.push_back({entry.path, entry.bytes, entry.refCount});
+    }
+    std::sort(resident.begin(), resident.end(), [](const TextureInfo &a, const TextureInfo &b)
+              { return a.bytes > b.bytes; });
+    return resident;
 }
 
 void ResourceManager::clear()
 {
-    for (auto &pair : textureCache)
+    // Stop background decodes first; this frees any surfaces not yet uploaded.
+    loader.reset();
+    pendingCount = 0;
+
+    for (auto &entry : textures)
     {
-        SDL_DestroyTexture(pair.second);
+        if (entry.texture)
+            SDL_DestroyTexture(entry.texture);
     }
-    textureCache.clear();
+    textures.assign(1, {"", nullptr, 0, TextureState::FAILED, 0, 0});
+    handlesByPath.clear();
+    residentBytes = 0;
 }
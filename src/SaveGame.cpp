@@ -0,0 +1,396 @@
+#include "SaveGame.h"
+#include "Game.h"
+#include "Hash.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace
+{
+    const char SAVE_MAGIC[4] = {'S', 'S', 'S', 'V'};
+    const size_t SECTION_ALIGNMENT = 8;
+
+    bool rangeFits(std::uint32_t first, std::uint32_t count, std::uint32_t total)
+    {
+        return first <= total && count <= total - first;
+    }
+}
+
+SaveGame::WeaponRecord SaveGame::recordWeapon(const Weapon &weapon)
+{
+    WeaponRecord record = {};
+    if (const ProjectileWeapon *projectile = std::get_if<ProjectileWeapon>(&weapon.impl))
+    {
+        record.type = static_cast<std::uint8_t>(projectile->type);
+        record.active = projectile->isFiring;
+        record.ammo = projectile->ammo;
+        record.fireRate = projectile->fireRate;
+        record.bulletSpeed = projectile->bulletSpeed;
+        record.damage = projectile->damage;
+        record.x = projectile->x;
+        record.y = projectile->y;
+        record.frame = projectile->fireFrame;
+        record.frameTime = projectile->fireFrameTime;
+    }
+    else
+    {
+        const MeleeWeapon &melee = std::get<MeleeWeapon>(weapon.impl);
+        record.melee = 1;
+        record.type = static_cast<std::uint8_t>(melee.type);
+        record.active = melee.attacking;
+        record.fireRate = melee.fireRate;
+        record.damage = melee.damage;
+        record.x = melee.x;
+        record.y = melee.y;
+        record.frame = melee.attackFrame;
+        record.frameTime = melee.attackFrameTime;
+    }
+    return record;
+}
+
+Weapon SaveGame::restoreWeapon(const WeaponRecord &record, SDL_Renderer *renderer)
+{
+    WeaponType type = static_cast<WeaponType>(record.type);
+    if (record.melee)
+    {
+        MeleeWeapon melee(type, record.fireRate, record.damage);
+        melee.x = record.x;
+        melee.y = record.y;
+        melee.attacking = record.active != 0;
+        melee.attackFrame = record.frame;
+        melee.attackFrameTime = record.frameTime;
+        melee.initialize(renderer);
+        return Weapon(std::move(melee));
+    }
+
+    ProjectileWeapon projectile(type, record.ammo, record.fireRate, record.bulletSpeed, record.damage);
+    projectile.x = record.x;
+    projectile.y = record.y;
+    projectile.isFiring = record.active != 0;
+    projectile.fireFrame = record.frame;
+    projectile.fireFrameTime = record.frameTime;
+    projectile.initialize(renderer);
+    return Weapon(std::move(projectile));
+}
+
+SaveGame::BulletRecord SaveGame::recordBullet(const Bullet &bullet)
+{
+    return {bullet.x, bullet.y, bullet.dx, bullet.dy, bullet.speed, bullet.active ? 1u : 0u};
+}
+
+Bullet SaveGame::restoreBullet(const BulletRecord &record)
+{
+    Bullet bullet(record.x, record.y, record.dx, record.dy, record.speed);
+    bullet.active = record.active != 0;
+    return bullet;
+}
+
+void SaveGame::write(const Game &game, std::vector<char> &out)
+{
+    std::vector<WeaponRecord> weapons;
+    std::vector<BulletRecord> bullets;
+    auto addWeapon = [&](const std::optional<Weapon> &weapon)
+    {
+        if (!weapon)
+            return NO_WEAPON;
+        weapons.push_back(recordWeapon(*weapon));
+        return static_cast<std::int32_t>(weapons.size() - 1);
+    };
+
+    GameRecord state = {};
+    state.rngState = game.rng.getState();
+    state.mapIndex = game.currentMapIndex;
+    state.aliveEnemies = game.aliveEnemies;
+    state.kills = game.stats.kills;
+    state.shotsFired = game.stats.shotsFired;
+    state.weaponsDropped = game.stats.weaponsDropped;
+    state.cameraX = game.camera.x;
+    state.cameraY = game.camera.y;
+    state.firstDroppedWeapon = static_cast<std::uint32_t>(weapons.size());
+    for (const auto &weapon : game.droppedWeapons)
+        weapons.push_back(recordWeapon(weapon));
+    state.droppedWeaponCount = static_cast<std::uint32_t>(game.droppedWeapons.size());
+    state.firstEnemyBullet = static_cast<std::uint32_t>(bullets.size());
+    for (const auto &bullet : game.enemyBullets)
+        bullets.push_back(recordBullet(bullet));
+    state.enemyBulletCount = static_cast<std::uint32_t>(game.enemyBullets.size());
+
+    const Player &player = *game.player;
+    const PlayerAnimation &animation = player.animation;
+    PlayerRecord hero = {};
+    hero.posX = player.posX;
+    hero.posY = player.posY;
+    hero.angle = player.angle;
+    hero.velX = player.velX;
+    hero.velY = player.velY;
+    hero.collisionBox[0] = player.collisionBox.x;
+    hero.collisionBox[1] = player.collisionBox.y;
+    hero.collisionBox[2] = player.collisionBox.w;
+    hero.collisionBox[3] = player.collisionBox.h;
+    hero.health = player.health;
+    hero.dead = player.dead;
+    hero.moving = player.isMoving;
+    hero.bareFistAttacking = player.bareFistAttacking;
+    hero.rightHand = animation.rightHand;
+    hero.currentWeapon = addWeapon(player.weapons.currentWeapon);
+    hero.weaponFireTimer = player.weapons.fireTimer;
+    hero.firstDroppedWeapon = static_cast<std::uint32_t>(weapons.size());
+    for (const auto &weapon : player.weapons.droppedWeapons)
+        weapons.push_back(recordWeapon(weapon));
+    hero.droppedWeaponCount = static_cast<std::uint32_t>(player.weapons.droppedWeapons.size());
+    hero.firstBullet = static_cast<std::uint32_t>(bullets.size());
+    for (const auto &bullet : player.bullets)
+        bullets.push_back(recordBullet(bullet));
+    hero.bulletCount = static_cast<std::uint32_t>(player.bullets.size());
+    hero.animationState = static_cast<std::int32_t>(animation.currentState);
+    hero.frame = animation.frame;
+    hero.frameTime = animation.frameTime;
+    hero.legsFrame = animation.legsFrame;
+    hero.legsFrameTime = animation.legsFrameTime;
+    hero.deadEffectFrame = animation.deadEffectFrame;
+    hero.deadEffectFrameTime = animation.deadEffectFrameTime;
+    hero.deadEffectDelayCounter = animation.deadEffectDelayCounter;
+    hero.deathFrame = animation.deathFrame;
+    hero.deathFrameTime = animation.deathFrameTime;
+
+    std::vector<EnemyRecord> enemies;
+    for (const auto &enemyPtr : game.enemies)
+    {
+        const Enemy &enemy = *enemyPtr;
+        EnemyRecord record = {};
+        record.x = enemy.x;
+        record.y = enemy.y;
+        record.speed = enemy.speed;
+        record.angle = enemy.angle;
+        record.fireTimer = enemy.fireTimer;
+        record.collisionBox[0] = enemy.collisionBox.x;
+        record.collisionBox[1] = enemy.collisionBox.y;
+        record.collisionBox[2] = enemy.collisionBox.w;
+        record.collisionBox[3] = enemy.collisionBox.h;
+        record.health = enemy.health;
+        record.state = static_cast<std::int32_t>(enemy.state);
+        record.runFrame = enemy.runFrame;
+        record.runFrameTime = enemy.runFrameTime;
+        record.deathFrame = enemy.deathFrame;
+        record.deathFrameTime = enemy.deathFrameTime;
+        record.deadEffectFrame = enemy.deadEffectFrame;
+        record.deadEffectFrameTime = enemy.deadEffectFrameTime;
+        record.deadEffectDelayCounter = enemy.deadEffectDelayCounter;
+        record.weapon = addWeapon(enemy.weapon);
+        record.boss = enemy.isBoss();
+        record.deathAnimationPlayed = enemy.deathAnimationPlayed;
+        enemies.push_back(record);
+    }
+
+    SaveHeader header = {};
+    std::memcpy(header.magic, SAVE_MAGIC, 4);
+    header.version = VERSION;
+    out.assign(sizeof(SaveHeader), 0);
+    auto appendSection = [&](Section section, const auto &records)
+    {
+        out.resize((out.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT, 0);
+        header.sections[section] = {static_cast<std::uint32_t>(out.size()), static_cast<std::uint32_t>(records.size())};
+        const char *begin = reinterpret_cast<const char *>(records.data());
+        out.insert(out.end(), begin, begin + records.size() * sizeof(records[0]));
+    };
+    appendSection(GAME, std::vector<GameRecord>{state});
+    appendSection(PLAYER, std::vector<PlayerRecord>{hero});
+    appendSection(ENEMIES, enemies);
+    appendSection(WEAPONS, weapons);
+    appendSection(BULLETS, bullets);
+
+    header.payloadSize = static_cast<std::uint32_t>(out.size() - sizeof(SaveHeader));
+    header.payloadHash = hashBytes(out.data() + sizeof(SaveHeader), header.payloadSize);
+    std::memcpy(out.data(), &header, sizeof(SaveHeader));
+}
+
+template <typename Record>
+const Record *SaveGame::fixUp(const std::vector<char> &bytes, const SectionEntry &entry)
+{
+    static_assert(std::is_trivially_copyable<Record>::value && alignof(Record) <= SECTION_ALIGNMENT,
+                  "save records are read in place");
+    if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > bytes.size() ||
+        entry.count > (bytes.size() - entry.offset) / sizeof(Record))
+        return nullptr;
+    return reinterpret_cast<const Record *>(bytes.data() + entry.offset);
+}
+
+bool SaveGame::read(const std::vector<char> &bytes, Game &game)
+{
+    // The buffer comes from operator new, so it is aligned for every record.
+    SaveHeader header;
+    if (bytes.size() < sizeof(SaveHeader))
+        return false;
+    std::memcpy(&header, bytes.data(), sizeof(SaveHeader));
+    if (std::memcmp(header.magic, SAVE_MAGIC, 4) != 0 || header.version != VERSION ||
+        header.payloadSize != bytes.size() - sizeof(SaveHeader) ||
+        header.payloadHash != hashBytes(bytes.data() + sizeof(SaveHeader), header.payloadSize))
+        return false;
+
+    const GameRecord *state = fixUp<GameRecord>(bytes, header.sections[GAME]);
+    const PlayerRecord *hero = fixUp<PlayerRecord>(bytes, header.sections[PLAYER]);
+    const EnemyRecord *enemies = fixUp<EnemyRecord>(bytes, header.sections[ENEMIES]);
+    const WeaponRecord *weapons = fixUp<WeaponRecord>(bytes, header.sections[WEAPONS]);
+    const BulletRecord *bullets = fixUp<BulletRecord>(bytes, header.sections[BULLETS]);
+    std::uint32_t enemyCount = header.sections[ENEMIES].count;
+    std::uint32_t weaponCount = header.sections[WEAPONS].count;
+    std::uint32_t bulletCount = header.sections[BULLETS].count;
+    if (!state || !hero || !enemies || !weapons || !bullets ||
+        header.sections[GAME].count != 1 || header.sections[PLAYER].count != 1)
+        return false;
+
+    // Check every cross-reference before touching the game.
+    auto validWeapon = [&](std::int32_t index)
+    { return index == NO_WEAPON || (index >= 0 && static_cast<std::uint32_t>(index) < weaponCount); };
+    if (state->mapIndex < 0 || state->mapIndex >= static_cast<int>(game.mapFiles.size()) ||
+        !rangeFits(state->firstDroppedWeapon, state->droppedWeaponCount, weaponCount) ||
+        !rangeFits(state->firstEnemyBullet, state->enemyBulletCount, bulletCount) ||
+        !rangeFits(hero->firstDroppedWeapon, hero->droppedWeaponCount, weaponCount) ||
+        !rangeFits(hero->firstBullet, hero->bulletCount, bulletCount) ||
+        !validWeapon(hero->currentWeapon) ||
+        hero->animationState < 0 || hero->animationState > static_cast<int>(AnimationState::ATTACKING))
+        return false;
+    for (std::uint32_t i = 0; i < enemyCount; i++)
+    {
+        if (!validWeapon(enemies[i].weapon) || enemies[i].state < 0 ||
+            enemies[i].state > static_cast<int>(EnemyState::DEAD))
+            return false;
+    }
+    for (std::uint32_t i = 0; i < weaponCount; i++)
+    {
+        if (weapons[i].type > static_cast<int>(WeaponType::UZI))
+            return false;
+    }
+
+    SDL_Renderer *renderer = game.renderer->getSDLRenderer();
+    if (!game.level || game.levelMapIndex != state->mapIndex)
+    {
+        game.currentMapIndex = state->mapIndex;
+        game.restartLevel(renderer);
+    }
+
+    game.rng.setState(state->rngState);
+    game.aliveEnemies = state->aliveEnemies;
+    game.stats.kills = state->kills;
+    game.stats.shotsFired = state->shotsFired;
+    game.stats.weaponsDropped = state->weaponsDropped;
+    game.camera.x = state->cameraX;
+    game.camera.y = state->cameraY;
+    game.droppedWeapons.clear();
+    for (std::uint32_t i = 0; i < state->droppedWeaponCount; i++)
+        game.droppedWeapons.push_back(restoreWeapon(weapons[state->firstDroppedWeapon + i], renderer));
+    game.enemyBullets.clear();
+    for (std::uint32_t i = 0; i < state->enemyBulletCount; i++)
+        game.enemyBullets.push_back(restoreBullet(bullets[state->firstEnemyBullet + i]));
+    game.events.clear();
+
+    Player &player = *game.player;
+    PlayerAnimation &animation = player.animation;
+    player.posX = player.prevX = hero->posX;
+    player.posY = player.prevY = hero->posY;
+    player.angle = hero->angle;
+    player.velX = hero->velX;
+    player.velY = hero->velY;
+    player.collisionBox = {hero->collisionBox[0], hero->collisionBox[1], hero->collisionBox[2], hero->collisionBox[3]};
+    player.health = hero->health;
+    player.dead = hero->dead != 0;
+    player.isMoving = hero->moving != 0;
+    player.bareFistAttacking = hero->bareFistAttacking != 0;
+    player.weapons.currentWeapon.reset();
+    if (hero->currentWeapon != NO_WEAPON)
+        player.weapons.currentWeapon = restoreWeapon(weapons[hero->currentWeapon], renderer);
+    player.weapons.fireTimer = hero->weaponFireTimer;
+    player.weapons.droppedWeapons.clear();
+    for (std::uint32_t i = 0; i < hero->droppedWeaponCount; i++)
+        player.weapons.droppedWeapons.push_back(restoreWeapon(weapons[hero->firstDroppedWeapon + i], renderer));
+    player.bullets.clear();
+    for (std::uint32_t i = 0; i < hero->bulletCount; i++)
+        player.bullets.push_back(restoreBullet(bullets[hero->firstBullet + i]));
+    animation.currentState = static_cast<AnimationState>(hero->animationState);
+    animation.rightHand = hero->rightHand != 0;
+    animation.frame = hero->frame;
+    animation.frameTime = hero->frameTime;
+    animation.legsFrame = hero->legsFrame;
+    animation.legsFrameTime = hero->legsFrameTime;
+    animation.deadEffectFrame = hero->deadEffectFrame;
+    animation.deadEffectFrameTime = hero->deadEffectFrameTime;
+    animation.deadEffectDelayCounter = hero->deadEffectDelayCounter;
+    animation.deathFrame = hero->deathFrame;
+    animation.deathFrameTime = hero->deathFrameTime;
+
+    game.enemies.clear();
+    for (std::uint32_t i = 0; i < enemyCount; i++)
+    {
+        const EnemyRecord &record = enemies[i];
+        std::unique_ptr<Enemy> enemy;
+        if (record.boss)
+            enemy = std::make_unique<BossEnemy>(record.x, record.y, renderer);
+        else
+            enemy = std::make_unique<Enemy>(record.x, record.y, renderer);
+        enemy->speed = record.speed;
+        enemy->angle = record.angle;
+        enemy->fireTimer = record.fireTimer;
+        enemy->collisionBox = {record.collisionBox[0], record.collisionBox[1], record.collisionBox[2], record.collisionBox[3]};
+        enemy->health = record.health;
+        enemy->state = static_cast<EnemyState>(record.state);
+        enemy->runFrame = record.runFrame;
+        enemy->runFrameTime = record.runFrameTime;
+        enemy->deathFrame = record.deathFrame;
+        enemy->deathFrameTime = record.deathFrameTime;
+        enemy->deadEffectFrame = record.deadEffectFrame;
+        enemy->deadEffectFrameTime = record.deadEffectFrameTime;
+        enemy->deadEffectDelayCounter = record.deadEffectDelayCounter;
+        enemy->deathAnimationPlayed = record.deathAnimationPlayed != 0;
+        enemy->weapon.reset();
+        if (record.weapon != NO_WEAPON)
+            enemy->weapon = restoreWeapon(weapons[record.weapon], renderer);
+        game.enemies.push_back(std::move(enemy));
+    }
+    return true;
+}
+
+bool SaveGame::save(const Game &game, const std::string &path)
+{
+    std::vector<char> bytes;
+    write(game, bytes);
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+        {
+            std::cerr << "Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error); // Replaces path in one step.
+    if (error)
+    {
+        std::cerr << "Failed to replace " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool SaveGame::load(Game &game, const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        std::cerr << "No save at " << path << std::endl;
+        return false;
+    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())) || !read(bytes, game))
+    {
+        std::cerr << "Save " << path << " is corrupt or from another version" << std::endl;
+        return false;
+    }
+    return true;
+}
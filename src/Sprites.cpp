@@ -0,0 +1,74 @@
+#include "Sprites.h"
+#include "Weapon.h"
+
+namespace
+{
+    const char *const WEAPON_DIR = "assets/weapons/";
+
+    std::string weaponName(WeaponType type)
+    {
+        switch (type)
+        {
+        case WeaponType::PISTOL:
+            return "pistol";
+        case WeaponType::SHOTGUN:
+            return "shotgun";
+        case WeaponType::SMG:
+            return "smg";
+        case WeaponType::AK:
+            return "ak";
+        case WeaponType::MG:
+            return "mg";
+        case WeaponType::UZI:
+            return "uzi";
+        case WeaponType::BASEBALL_BAT:
+            return "bat";
+        case WeaponType::KNIFE:
+            return "knife";
+        case WeaponType::BAREFIST:
+            return "barefist";
+        }
+        return "default";
+    }
+}
+
+std::string Sprites::weaponHeld(WeaponType type)
+{
+    return WEAPON_DIR + weaponName(type) + "_held.png";
+}
+
+std::string Sprites::weaponDropped(WeaponType type)
+{
+    return WEAPON_DIR + weaponName(type) + "_dropped.png";
+}
+
+std::string Sprites::weaponAttack(WeaponType type)
+{
+    return WEAPON_DIR + weaponName(type) + "_attack.png";
+}
+
+std::vector<std::string> Sprites::gameplaySprites()
+{
+    return {
+        PLAYER_IDLE,
+        PLAYER_RUN,
+        PLAYER_PUNCH,
+        PLAYER_IDLE_ATTACHED,
+        PLAYER_RUN_ATTACHED,
+        PLAYER_DEAD,
+        PLAYER_LEGS,
+        DEATH_EFFECT,
+        ENEMY_IDLE,
+        ENEMY_RUN,
+        ENEMY_DEAD,
+        BOSS_IDLE,
+        BOSS_RUN,
+        BOSS_DEAD,
+        weaponHeld(WeaponType::BASEBALL_BAT),
+        weaponAttack(WeaponType::BASEBALL_BAT),
+        weaponDropped(WeaponType::BASEBALL_BAT),
+        weaponHeld(WeaponType::SHOTGUN),
+        weaponDropped(WeaponType::SHOTGUN),
+        WEAPON_FIRE,
+    };
+}
@@ -1,6 +1,9 @@
 #include "Weapon.h"
+#include "EventBus.h"
 #include "Constants.h"
 #include "ResourceManager.h"
+#include "RenderStats.h"
+#include "Sprites.h"
 #include <SDL2/SDL_image.h>
 #include <cmath>
 #include <iostream>
@@ -8,45 +11,19 @@
 // ----------------- ProjectileWeapon -----------------
 ProjectileWeapon::ProjectileWeapon(WeaponType type, int ammo, float fireRate, float bulletSpeed, int damage)
     : type(type), ammo(ammo), fireRate(fireRate), bulletSpeed(bulletSpeed), damage(damage), x(0), y(0),
-      isFiring(false), fireFrame(0), fireFrameTime(0),
-      heldTexture(nullptr), droppedTexture(nullptr), fireTexture(nullptr)
+      isFiring(false), fireFrame(0), fireFrameTime(0)
 {
 }
 
 void ProjectileWeapon::initialize(SDL_Renderer *renderer)
 {
-    std::string basePath = "assets/weapons/";
-    std::string weaponName;
-    switch (type)
-    {
-    case WeaponType::PISTOL:
-        weaponName = "pistol";
-        break;
-    case WeaponType::SHOTGUN:
-        weaponName = "shotgun";
-        break;
-    case WeaponType::SMG:
-        weaponName = "smg";
-        break;
-    case WeaponType::AK:
-        weaponName = "ak";
-        break;
-    case WeaponType::MG:
-        weaponName = "mg";
-        break;
-    case WeaponType::UZI:
-        weaponName = "uzi";
-        break;
-    default:
-        weaponName = "default";
-        break;
-    }
-    heldTexture = ResourceManager::loadTexture(renderer, basePath + weaponName + "_held.png");
-    droppedTexture = ResourceManager::loadTexture(renderer, basePath + weaponName + "_dropped.png");
-    fireTexture = ResourceManager::loadTexture(renderer, basePath + "fire.png");
+    heldTexture = TextureRef(renderer, Sprites::weaponHeld(type));
+    droppedTexture = TextureRef(renderer, Sprites::weaponDropped(type));
+    fireTexture = TextureRef(renderer, Sprites::WEAPON_FIRE);
 }
 
-void ProjectileWeapon::shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY)
+void ProjectileWeapon::shoot(std::vector<Bullet> &bullets, float playerX, float playerY, float aimX, float aimY,
+                             EventBus *events, EventTarget shooter)
 {
     if (!hasAmmo())
         return;
@@ -61,6 +38,8 @@ void ProjectileWeapon::shoot(std::vector<Bullet> &bullets, float playerX, float
 
     // Spawn a new bullet.
     bullets.emplace_back(playerX, playerY, dx, dy, bulletSpeed);
+    if (events)
+        events->shotsFired.push({shooter, playerX, playerY});
     if (ammo > 0)
         ammo--;
 
@@ -97,7 +76,7 @@ void ProjectileWeapon::render(SDL_Renderer *renderer, float posX, float posY, fl
         destRect.x = static_cast<int>(posX + (PLAYER_SPRITE_WIDTH - 54) / 2);
         destRect.y = static_cast<int>(posY + (PLAYER_SPRITE_HEIGHT - 54) / 2);
         SDL_Point center = {27, 27};
-        SDL_RenderCopyEx(renderer, heldTexture, nullptr, &destRect, angle, &center, SDL_FLIP_NONE);
+        RenderStats::copyEx(renderer, heldTexture.get(), nullptr, &destRect, angle, &center, SDL_FLIP_NONE);
 
         // Render fire animation if firing.
         if (isFiring && fireTexture)
@@ -113,13 +92,13 @@ void ProjectileWeapon::render(SDL_Renderer *renderer, float posX, float posY, fl
             fireDest.w = 16;
             fireDest.h = 16;
             SDL_Point fireCenter = {8, 8};
-            SDL_RenderCopyEx(renderer, fireTexture, &fireSrc, &fireDest, angle, &fireCenter, SDL_FLIP_NONE);
+            RenderStats::copyEx(renderer, fireTexture.get(), &fireSrc, &fireDest, angle, &fireCenter, SDL_FLIP_NONE);
         }
     }
     else
     {
         int texW = 0, texH = 0;
-        SDL_QueryTexture(droppedTexture, NULL, NULL, &texW, &texH);
+        SDL_QueryTexture(droppedTexture.get(), NULL, NULL, &texW, &texH);
         // Optionally, scale the texture (for example, half size):
         float scale = 1.0f; // adjust as needed
         SDL_Rect destRect;
@@ -127,7 +106,7 @@ void ProjectileWeapon::render(SDL_Renderer *renderer, float posX, float posY, fl
         destRect.y = static_cast<int>(posY);
         destRect.w = static_cast<int>(texW * scale);
         destRect.h = static_cast<int>(texH * scale);
-        SDL_RenderCopy(renderer, droppedTexture, nullptr, &destRect);
+        RenderStats::copy(renderer, droppedTexture.get(), nullptr, &destRect);
     }
 }
 
@@ -139,41 +118,24 @@ bool ProjectileWeapon::hasAmmo() const
 // ----------------- MeleeWeapon -----------------
 MeleeWeapon::MeleeWeapon(WeaponType type, float fireRate, int damage)
     : type(type), fireRate(fireRate), damage(damage), x(0), y(0),
-      isAttacking(false), attackFrame(0), attackFrameTime(0),
-      heldTexture(nullptr), attackTexture(nullptr), droppedTexture(nullptr)
+      attacking(false), attackFrame(0), attackFrameTime(0)
 {
 }
 
 void MeleeWeapon::initialize(SDL_Renderer *renderer)
 {
-    std::string basePath = "assets/weapons/";
-    std::string weaponName;
-    switch (type)
-    {
-    case WeaponType::BASEBALL_BAT:
-        weaponName = "bat";
-        break;
-    case WeaponType::KNIFE:
-        weaponName = "knife";
-        break;
-    case WeaponType::BAREFIST:
-        weaponName = "barefist";
-        break;
-    default:
-        weaponName = "default";
-        break;
-    }
-    heldTexture = ResourceManager::loadTexture(renderer, basePath + weaponName + "_held.png");
-    attackTexture = ResourceManager::loadTexture(renderer, basePath + weaponName + "_attack.png");
-    droppedTexture = ResourceManager::loadTexture(renderer, basePath + weaponName + "_dropped.png");
+    heldTexture = TextureRef(renderer, Sprites::weaponHeld(type));
+    attackTexture = TextureRef(renderer, Sprites::weaponAttack(type));
+    droppedTexture = TextureRef(renderer, Sprites::weaponDropped(type));
 }
 
-void MeleeWeapon::shoot(std::vector<Bullet> & /*bullets*/, float playerX, float playerY, float /*aimX*/, float /*aimY*/)
+void MeleeWeapon::shoot(std::vector<Bullet> & /*bullets*/, float playerX, float playerY, float /*aimX*/, float /*aimY*/,
+                        EventBus * /*events*/, EventTarget /*shooter*/)
 {
     // For melee, shooting triggers an attack.
-    if (!isAttacking)
+    if (!attacking)
     {
-        isAttacking = true;
+        attacking = true;
         attackFrame = 0;
         attackFrameTime = 0;
     }
@@ -181,7 +143,7 @@ void MeleeWeapon::shoot(std::vector<Bullet> & /*bullets*/, float playerX, float
 
 void MeleeWeapon::update()
 {
-    if (isAttacking)
+    if (attacking)
     {
         attackFrameTime++;
         if (attackFrameTime >= ATTACK_FRAME_SPEED)
@@ -191,7 +153,7 @@ void MeleeWeapon::update()
         }
         if (attackFrame >= ATTACK_FRAMES)
         {
-            isAttacking = false;
+            attacking = false;
             attackFrame = 0;
         }
     }
@@ -209,23 +171,23 @@ void MeleeWeapon::render(SDL_Renderer *renderer, float posX, float posY, float a
         destRect.w = 54;
         destRect.h = 54;
         SDL_Point center = {27, 27};
-        if (isAttacking && attackTexture)
+        if (attacking && attackTexture)
         {
             // During attack, render the attack animation only.
             SDL_Rect srcRect = {attackFrame * 54, 0, 54, 54};
-            SDL_RenderCopyEx(renderer, attackTexture, &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
+            RenderStats::copyEx(renderer, attackTexture.get(), &srcRect, &destRect, angle, &center, SDL_FLIP_NONE);
         }
         else
         {
             // Otherwise, render the held texture.
-            SDL_RenderCopyEx(renderer, heldTexture, nullptr, &destRect, angle, &center, SDL_FLIP_NONE);
+            RenderStats::copyEx(renderer, heldTexture.get(), nullptr, &destRect, angle, &center, SDL_FLIP_NONE);
         }
     }
     else
     {
         // When dropped, render the dropped image.
         int texW = 0, texH = 0;
-        SDL_QueryTexture(droppedTexture, NULL, NULL, &texW, &texH);
+        SDL_QueryTexture(droppedTexture.get(), NULL, NULL, &texW, &texH);
         // Optionally, scale the texture (for example, half size):
         float scale = 1.0f; // adjust as needed
         SDL_Rect destRect;
@@ -233,6 +195,6 @@ void MeleeWeapon::render(SDL_Renderer *renderer, float posX, float posY, float a
         destRect.y = static_cast<int>(posY);
         destRect.w = static_cast<int>(texW * scale);
         destRect.h = static_cast<int>(texH * scale);
-        SDL_RenderCopy(renderer, droppedTexture, nullptr, &destRect);
+        RenderStats::copy(renderer, droppedTexture.get(), nullptr, &destRect);
     }
 }
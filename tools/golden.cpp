@@ -0,0 +1,297 @@
+// golden.cpp
+// Golden-image check for the render path. Renders a fixed set of scenes
+// through the software renderer and compares each one with a checked-in PNG
+// in golden/:
+//  - every map, level only, with the camera at its top-left corner, centre
+//    and bottom-right corner;
+//  - every golden/*.rep replay at a few ticks, drawn by Game with all its
+//    entities.
+// A pixel matches when no channel differs by more than the tolerance. For a
+// scene that does not match, the actual frame and a diff image (mismatches
+// in red over the dimmed golden) are written to golden/out/.
+//
+// Usage: golden [--update] [--tolerance N] [--max-mismatch FRACTION]
+// --update rewrites the goldens from the current output instead of checking.
+// Must be run from the repository root; exits with 1 if any scene fails and
+// with 2 if golden/ holds no images at all.
+#define SDL_MAIN_HANDLED
+#include "Constants.h"
+#include "Game.h"
+#include "Level.h"
+#include "ResourceManager.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char *const GOLDEN_DIR = "golden";
+    const char *const OUTPUT_DIR = "golden/out";
+    const char *const MAPS[] = {"map1", "map2", "map3", "infinite"};
+    const long REPLAY_TICKS[] = {SIMULATION_HZ, 5 * SIMULATION_HZ, 15 * SIMULATION_HZ};
+
+    struct Options
+    {
+        bool update = false;
+        int tolerance = 2;        // Per channel, 0..255.
+        double maxMismatch = 0.0; // Fraction of pixels allowed past the tolerance.
+    };
+
+    struct Totals
+    {
+        int passed = 0;
+        int failed = 0;
+        int updated = 0;
+    };
+
+    Uint32 *pixelAt(SDL_Surface *surface, int x, int y)
+    {
+        return reinterpret_cast<Uint32 *>(static_cast<char *>(surface->pixels) + y * surface->pitch) + x;
+    }
+
+    int channelDifference(Uint32 a, Uint32 b)
+    {
+        int largest = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            int difference = std::abs(static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF));
+            largest = std::max(largest, difference);
+        }
+        return largest;
+    }
+
+    bool hasGoldens()
+    {
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(GOLDEN_DIR, error))
+        {
+            if (entry.path().extension() == ".png")
+                return true;
+        }
+        return false;
+    }
+
+    // Checks (or with --update, stores) one rendered scene. actual must be
+    // ARGB8888; it is not freed.
+    void checkScene(const std::string &name, SDL_Surface *actual, const Options &options, Totals &totals)
+    {
+        std::string goldenPath = std::string(GOLDEN_DIR) + "/" + name + ".png";
+        std::string actualPath = std::string(OUTPUT_DIR) + "/" + name + ".png";
+        std::string diffPath = std::string(OUTPUT_DIR) + "/" + name + "_diff.png";
+
+        if (options.update)
+        {
+            if (IMG_SavePNG(actual, goldenPath.c_str()) != 0)
+            {
+                std::printf("FAIL %-28s cannot write %s: %s\n", name.c_str(), goldenPath.c_str(), IMG_GetError());
+                totals.failed++;
+                return;
+            }
+            std::printf("UPDATE %s\n", goldenPath.c_str());
+            totals.updated++;
+            return;
+        }
+
+        SDL_Surface *loaded = IMG_Load(goldenPath.c_str());
+        SDL_Surface *golden = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+        SDL_FreeSurface(loaded);
+        if (!golden)
+        {
+            std::printf("FAIL %-28s no golden at %s (run with --update)\n", name.c_str(), goldenPath.c_str());
+            IMG_SavePNG(actual, actualPath.c_str());
+            totals.failed++;
+            return;
+        }
+        if (golden->w != actual->w || golden->h != actual->h)
+        {
+            std::printf("FAIL %-28s size %dx%d, golden is %dx%d\n", name.c_str(), actual->w, actual->h, golden->w, golden->h);
+            IMG_SavePNG(actual, actualPath.c_str());
+            SDL_FreeSurface(golden);
+            totals.failed++;
+            return;
+        }
+
+        // Build the diff in place over the golden: dimmed where the pixels
+        // match, red scaled by the difference where they do not.
+        long mismatches = 0;
+        int worst = 0;
+        for (int y = 0; y < golden->h; y++)
+        {
+            for (int x = 0; x < golden->w; x++)
+            {
+                Uint32 *expected = pixelAt(golden, x, y);
+                int difference = channelDifference(*expected, *pixelAt(actual, x, y));
+                worst = std::max(worst, difference);
+                if (difference > options.tolerance)
+                {
+                    mismatches++;
+                    Uint32 red = 128 + difference / 2;
+                    *expected = 0xFF000000u | (red << 16);
+                }
+                else
+                {
+                    Uint32 gray = (((*expected >> 16) & 0xFF) + ((*expected >> 8) & 0xFF) + (*expected & 0xFF)) / 12;
+                    *expected = 0xFF000000u | (gray << 16) | (gray << 8) | gray;
+                }
+            }
+        }
+
+        long total = static_cast<long>(golden->w) * golden->h;
+        if (mismatches <= options.maxMismatch * total)
+        {
+            std::printf("ok   %-28s %ld pixels differ, max channel difference %d\n", name.c_str(), mismatches, worst);
+            totals.passed++;
+        }
+        else
+        {
+            std::printf("FAIL %-28s %ld of %ld pixels differ, max channel difference %d; see %s\n",
+                        name.c_str(), mismatches, total, worst, diffPath.c_str());
+            IMG_SavePNG(actual, actualPath.c_str());
+            IMG_SavePNG(golden, diffPath.c_str());
+            totals.failed++;
+        }
+        SDL_FreeSurface(golden);
+    }
+
+    // Each map on its own, at three camera positions. A fresh Level per
+    // scene, so infinite maps decode exactly the visible chunks first.
+    void checkMaps(const Options &options, Totals &totals)
+    {
+        SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+        if (!renderer)
+        {
+            std::printf("FAIL no software renderer: %s\n", SDL_GetError());
+            SDL_FreeSurface(target);
+            totals.failed++;
+            return;
+        }
+
+        const struct
+        {
+            const char *name;
+            float u, v; // Fraction of the map's scrollable range.
+        } cameras[] = {{"topleft", 0.0f, 0.0f}, {"center", 0.5f, 0.5f}, {"bottomright", 1.0f, 1.0f}};
+
+        for (const char *map : MAPS)
+        {
+            std::string mapPath = std::string("assets/map/") + map + ".json";
+            for (const auto &camera : cameras)
+            {
+                Level level(renderer, mapPath);
+                SDL_Rect bounds = level.getBounds();
+                int cameraX = bounds.x + static_cast<int>((bounds.w - SCREEN_WIDTH) * camera.u);
+                int cameraY = bounds.y + static_cast<int>((bounds.h - SCREEN_HEIGHT) * camera.v);
+                level.update({cameraX, cameraY, SCREEN_WIDTH, SCREEN_HEIGHT});
+
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                SDL_RenderClear(renderer);
+                level.render(renderer, cameraX, cameraY);
+                SDL_RenderPresent(renderer);
+                checkScene(std::string(map) + "_" + camera.name, target, options, totals);
+            }
+        }
+
+        // Textures belong to this renderer.
+        ResourceManager::clear();
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(target);
+    }
+
+    // Game frames from each replay in golden/, after REPLAY_TICKS ticks.
+    void checkReplays(const Options &options, Totals &totals)
+    {
+        std::vector<std::filesystem::path> replays;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(GOLDEN_DIR, error))
+        {
+            if (entry.path().extension() == ".rep")
+                replays.push_back(entry.path());
+        }
+        std::sort(replays.begin(), replays.end());
+
+        for (const auto &replayPath : replays)
+        {
+            std::string stem = replayPath.stem().string();
+            Game game;
+            if (!game.init("golden", SCREEN_WIDTH, SCREEN_HEIGHT, true) || !game.startReplay(replayPath.string()))
+            {
+                std::printf("FAIL %-28s cannot play %s\n", stem.c_str(), replayPath.string().c_str());
+                totals.failed++;
+                continue;
+            }
+
+            for (long tick : REPLAY_TICKS)
+            {
+                while (game.isRunning() && static_cast<long>(game.getReplayTick()) < tick)
+                    game.update();
+                if (!game.isRunning())
+                    break; // The replay is shorter; later ticks are skipped.
+
+                SDL_Surface *frame = game.captureFrame();
+                std::string name = stem + "_t" + std::to_string(tick);
+                if (!frame)
+                {
+                    std::printf("FAIL %-28s no frame\n", name.c_str());
+                    totals.failed++;
+                    continue;
+                }
+                checkScene(name, frame, options, totals);
+                SDL_FreeSurface(frame);
+            }
+            game.clean();
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--update") == 0)
+            options.update = true;
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            options.tolerance = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-mismatch") == 0 && i + 1 < argc)
+            options.maxMismatch = std::atof(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--update] [--tolerance N] [--max-mismatch FRACTION]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Without a single golden every scene would just fail; say what is
+    // missing instead.
+    if (!options.update && !hasGoldens())
+    {
+        std::fprintf(stderr, "No golden images in %s/. Generate them with --update (make golden-update) "
+                             "on a machine with SDL2 and SDL2_image, review and commit them.\n", GOLDEN_DIR);
+        return 2;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.update ? GOLDEN_DIR : OUTPUT_DIR, error);
+    if (error)
+    {
+        std::fprintf(stderr, "Cannot create output directory: %s\n", error.message().c_str());
+        return 2;
+    }
+
+    Totals totals;
+    checkMaps(options, totals);
+    checkReplays(options, totals);
+
+    if (options.update)
+        std::printf("%d goldens written, %d failed\n", totals.updated, totals.failed);
+    else
+        std::printf("%d scenes passed, %d failed\n", totals.passed, totals.failed);
+    return totals.failed == 0 ? 0 : 1;
+}
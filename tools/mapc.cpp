@@ -0,0 +1,31 @@
+// mapc: cooks Tiled JSON maps into the binary .lvl files Level loads.
+// Usage: mapc <map.json>...
+#define SDL_MAIN_HANDLED // Plain console tool; no SDL2main.
+#include "LevelFormat.h"
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: mapc <map.json>..." << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string jsonPath = argv[i];
+        std::string cookedPath = LevelFormat::cookedPathFor(jsonPath);
+        if (LevelFormat::cook(jsonPath, cookedPath))
+        {
+            std::cout << jsonPath << " -> " << cookedPath << std::endl;
+        }
+        else
+        {
+            std::cerr << "Failed to cook " << jsonPath << std::endl;
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
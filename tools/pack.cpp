@@ -0,0 +1,46 @@
+// pack: bundles the runtime assets under one or more directories into an
+// asset pack the game memory-maps at startup.
+// Usage: pack <out.pak> <dir>...
+#include "AssetPack.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: pack <out.pak> <dir>..." << std::endl;
+        return 1;
+    }
+
+    // Only what the game loads; editor project files and videos stay out.
+    const std::vector<std::string> extensions = {".png", ".jpg", ".json", ".lvl"};
+
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+    {
+        std::error_code error;
+        for (fs::recursive_directory_iterator it(argv[i], error), end; it != end; it.increment(error))
+        {
+            if (!it->is_regular_file())
+                continue;
+            std::string extension = it->path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            if (std::find(extensions.begin(), extensions.end(), extension) != extensions.end())
+                files.push_back(it->path().generic_string());
+        }
+        if (error)
+        {
+            std::cerr << "Failed to scan " << argv[i] << ": " << error.message() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!AssetPack::build(argv[1], files))
+        return 1;
+    std::cout << "Packed " << files.size() << " files into " << argv[1] << std::endl;
+    return 0;
+}